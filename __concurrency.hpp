@@ -0,0 +1,40 @@
+#ifndef STL_IMPL__CONCURRENCY_
+#define STL_IMPL__CONCURRENCY_
+
+#include <cstddef>
+#include <thread>
+
+namespace stl {
+
+// Shared by the concurrent containers.
+// Indices written by different threads are kept __cache_line_size apart so
+// that the producer and consumer sides never false-share a line.
+// (std::hardware_destructive_interference_size is not available everywhere.)
+constexpr std::size_t __cache_line_size = 64;
+
+// Busy-wait hint for spin loops.
+inline void __cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Spin a little, then give the time slice away.
+struct __backoff {
+    unsigned count = 0;
+    void operator()() {
+        if (count < 64) {
+            ++count;
+            __cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL__CONCURRENCY_ */
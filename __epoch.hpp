@@ -0,0 +1,266 @@
+#ifndef STL_IMPL__EPOCH_
+#define STL_IMPL__EPOCH_
+
+#include <cstddef>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "memory/alloc.hpp"
+#include "__concurrency.hpp"
+
+namespace stl {
+
+// Epoch-based reclamation for the lock-free containers.
+// A thread pins itself (guard) around every access that may dereference a
+// shared node.  Unlinked nodes are retire()d into the retiring thread's
+// limbo list tagged with the global epoch; the epoch only advances once every
+// pinned thread has observed the current one, so a node retired in epoch e is
+// unreachable by anybody once the epoch has reached e + 2 and its reclaim
+// function runs then.
+//
+// Reclaimed blocks are kept in a per-thread cache in front of threaded_alloc,
+// so steady-state node turnover never takes the pool lock.  A thread's limbo
+// lists are drained and its cache returned to the pool when it exits.
+
+struct __epoch_node {
+    __epoch_node* retired_next;
+    void (*reclaim)(__epoch_node*);
+};
+
+template<int inst>
+class __epoch_template {
+public:
+    enum { max_threads = 256 };
+    enum { collect_interval = 64 };     // retires between collection attempts
+    enum { cache_limit = 256 };         // cached blocks per size class
+
+private:
+    struct alignas(__cache_line_size) record {
+        std::atomic<unsigned> state;        // 0, or (epoch << 1) | 1 while pinned
+        std::atomic<bool> taken;
+    };
+
+    struct cached_block {
+        cached_block* next;
+    };
+
+    struct local {
+        record* rec = 0;
+        unsigned depth = 0;
+        unsigned retired = 0;
+        bool exiting = false;
+        __epoch_node* limbo[3] = {0, 0, 0};
+        unsigned limbo_epoch[3] = {0, 0, 0};
+        cached_block* cache[memory::__NFREELISTS] = {};
+        unsigned cache_count[memory::__NFREELISTS] = {};
+
+        ~local();
+    };
+
+    static std::atomic<unsigned> global_epoch;
+    static std::atomic<unsigned> record_count;     // high-water mark
+    static record records[max_threads];
+
+    static local& this_thread() {
+        static thread_local local l;
+        return l;
+    }
+    static record* acquire_record();
+    static void enter(local& l);
+    static void leave(local& l);
+    static void retire(local& l, __epoch_node* p, void (*reclaim)(__epoch_node*));
+    static bool try_advance();
+    static void collect(local& l);
+    static void reclaim_list(__epoch_node* p);
+    static std::size_t cache_index(std::size_t n) {
+        return (n + memory::__ALIGN - 1) / memory::__ALIGN - 1;
+    }
+
+public:
+    // Pins the calling thread for its lifetime; nests.
+    class guard {
+    public:
+        guard() : l(this_thread()) { enter(l); }
+        ~guard() { leave(l); }
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+        // retire() without looking the thread state up again
+        void retire(__epoch_node* p, void (*reclaim)(__epoch_node*)) {
+            __epoch_template::retire(l, p, reclaim);
+        }
+    private:
+        local& l;
+    };
+
+    static void retire(__epoch_node* p, void (*reclaim)(__epoch_node*)) {
+        retire(this_thread(), p, reclaim);
+    }
+
+    static void* allocate(std::size_t n);
+    static void deallocate(void* p, std::size_t n);
+};
+
+template<int inst>
+std::atomic<unsigned> __epoch_template<inst>::global_epoch(0);
+
+template<int inst>
+std::atomic<unsigned> __epoch_template<inst>::record_count(0);
+
+template<int inst>
+typename __epoch_template<inst>::record __epoch_template<inst>::records[max_threads];
+
+template<int inst>
+typename __epoch_template<inst>::record* __epoch_template<inst>::acquire_record()
+{
+    for (unsigned i = 0; i < unsigned(max_threads); ++i) {
+        bool expected = false;
+        if (!records[i].taken.load(std::memory_order_relaxed)
+            && records[i].taken.compare_exchange_strong(expected, true)) {
+            unsigned count = record_count.load();
+            while (count <= i && !record_count.compare_exchange_weak(count, i + 1)) { }
+            return &records[i];
+        }
+    }
+    throw std::length_error("__epoch: too many threads");
+}
+
+template<int inst>
+void __epoch_template<inst>::enter(local& l)
+{
+    if (l.depth++ != 0)
+        return;
+    if (!l.rec)
+        l.rec = acquire_record();
+    unsigned e = global_epoch.load(std::memory_order_seq_cst);
+    l.rec->state.store((e << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+template<int inst>
+void __epoch_template<inst>::leave(local& l)
+{
+    if (--l.depth == 0)
+        l.rec->state.store(0, std::memory_order_release);
+}
+
+// The epoch may move from e to e + 1 once no thread is pinned at an older one.
+template<int inst>
+bool __epoch_template<inst>::try_advance()
+{
+    unsigned e = global_epoch.load(std::memory_order_seq_cst);
+    unsigned pinned_here = (e << 1) | 1;
+    unsigned n = record_count.load(std::memory_order_acquire);
+    for (unsigned i = 0; i < n; ++i) {
+        unsigned s = records[i].state.load(std::memory_order_seq_cst);
+        if ((s & 1) && s != pinned_here)
+            return false;
+    }
+    return global_epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+}
+
+template<int inst>
+void __epoch_template<inst>::reclaim_list(__epoch_node* p)
+{
+    while (p) {
+        __epoch_node* next = p->retired_next;
+        p->reclaim(p);
+        p = next;
+    }
+}
+
+template<int inst>
+void __epoch_template<inst>::collect(local& l)
+{
+    l.retired = 0;
+    try_advance();
+    unsigned e = global_epoch.load(std::memory_order_seq_cst);
+    for (int b = 0; b < 3; ++b) {
+        if (l.limbo[b] && e - l.limbo_epoch[b] >= 2) {
+            __epoch_node* p = l.limbo[b];
+            l.limbo[b] = 0;
+            reclaim_list(p);
+        }
+    }
+}
+
+template<int inst>
+void __epoch_template<inst>::retire(local& l, __epoch_node* p, void (*reclaim)(__epoch_node*))
+{
+    p->reclaim = reclaim;
+    unsigned e = global_epoch.load(std::memory_order_seq_cst);
+    int b = e % 3;
+    if (l.limbo[b] && e - l.limbo_epoch[b] >= 2) {
+        __epoch_node* old = l.limbo[b];
+        l.limbo[b] = 0;
+        reclaim_list(old);
+    }
+    // a bucket is tagged with its newest epoch, older nodes just wait longer
+    p->retired_next = l.limbo[b];
+    l.limbo[b] = p;
+    l.limbo_epoch[b] = e;
+    if (++l.retired >= unsigned(collect_interval))
+        collect(l);
+}
+
+template<int inst>
+void* __epoch_template<inst>::allocate(std::size_t n)
+{
+    if (n > std::size_t(memory::__MAX_BYTES))
+        return memory::threaded_alloc::allocate(n);
+    local& l = this_thread();
+    std::size_t i = cache_index(n);
+    if (cached_block* p = l.cache[i]) {
+        l.cache[i] = p->next;
+        --l.cache_count[i];
+        return p;
+    }
+    return memory::threaded_alloc::allocate(n);
+}
+
+template<int inst>
+void __epoch_template<inst>::deallocate(void* p, std::size_t n)
+{
+    if (n > std::size_t(memory::__MAX_BYTES)) {
+        memory::threaded_alloc::deallocate(p, n);
+        return;
+    }
+    local& l = this_thread();
+    std::size_t i = cache_index(n);
+    if (l.exiting || l.cache_count[i] >= unsigned(cache_limit)) {
+        memory::threaded_alloc::deallocate(p, n);
+        return;
+    }
+    cached_block* q = static_cast<cached_block*>(p);
+    q->next = l.cache[i];
+    l.cache[i] = q;
+    ++l.cache_count[i];
+}
+
+template<int inst>
+__epoch_template<inst>::local::~local()
+{
+    // Wait for the other threads to move past our retired nodes; they only
+    // stay pinned for the length of one container operation.
+    exiting = true;
+    for (;;) {
+        collect(*this);
+        if (!limbo[0] && !limbo[1] && !limbo[2])
+            break;
+        std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < std::size_t(memory::__NFREELISTS); ++i) {
+        while (cached_block* p = cache[i]) {
+            cache[i] = p->next;
+            memory::threaded_alloc::deallocate(p, (i + 1) * memory::__ALIGN);
+        }
+    }
+    if (rec)
+        rec->taken.store(false, std::memory_order_release);
+}
+
+typedef __epoch_template<0> __epoch;
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL__EPOCH_ */
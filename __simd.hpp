@@ -0,0 +1,1029 @@
+#ifndef STL_IMPL_SIMD_
+#define STL_IMPL_SIMD_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "__type_traits.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define __STL_SIMD_X86 1
+#include <immintrin.h>
+#define __STL_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+namespace stl {
+
+// Vector kernels for the algorithms over contiguous ranges of arithmetic
+// types.  SSE2 is the x86-64 baseline and is always there; AVX2 is
+// picked at run time when the CPU has it.  Everything else runs the plain
+// loops.  __simd_max_level() can be lowered to test or time the narrower
+// paths.
+
+enum { __simd_scalar = 0, __simd_sse2 = 1, __simd_avx2 = 2 };
+
+inline int& __simd_max_level() {
+    static int level = __simd_avx2;
+    return level;
+}
+
+inline int __simd_cpu_level() {
+#ifdef __STL_SIMD_X86
+    static const int level =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? __simd_avx2
+                                                                           : __simd_sse2;
+    return level;
+#else
+    return __simd_scalar;
+#endif
+}
+
+inline int __simd_level() {
+    int cpu = __simd_cpu_level();
+    return cpu < __simd_max_level() ? cpu : __simd_max_level();
+}
+
+// Fills and copies of at least this many bytes use non-temporal stores,
+// which go around the cache instead of evicting everything else from it.
+inline std::size_t& __simd_stream_threshold() {
+    static std::size_t bytes = std::size_t(4) << 20;
+    return bytes;
+}
+
+// Element types the kernels handle: integers of 1, 2, 4 or 8 bytes except
+// bool, float and double.
+template<typename T>
+struct __simd_traits {
+    enum { value = (std::is_integral<T>::value && !std::is_same<T, bool>::value
+                    && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))
+                   || std::is_same<T, float>::value || std::is_same<T, double>::value };
+    typedef typename std::conditional<value, __traits::__true_type,
+                                      __traits::__false_type>::type is_vectorizable;
+};
+
+// The element tests: x op value.
+enum { __simd_eq, __simd_ne, __simd_lt, __simd_gt, __simd_le, __simd_ge };
+
+template<int Op, typename T>
+inline bool __simd_test(const T& x, const T& value) {
+    switch (Op) {
+    case __simd_eq: return x == value;
+    case __simd_ne: return x != value;
+    case __simd_lt: return x < value;
+    case __simd_gt: return x > value;
+    case __simd_le: return x <= value;
+    default:        return x >= value;
+    }
+}
+
+template<int Op, typename T>
+const T* __scalar_find_if(const T* first, const T* last, T value) {
+    while (first != last && !::stl::__simd_test<Op>(*first, value))
+        ++first;
+    return first;
+}
+
+// the last element passing the test, last if there is none
+template<int Op, typename T>
+const T* __scalar_find_last_if(const T* first, const T* last, T value) {
+    for (const T* p = last; p != first; )
+        if (::stl::__simd_test<Op>(*--p, value))
+            return p;
+    return last;
+}
+
+template<int Op, typename T>
+std::ptrdiff_t __scalar_count_if(const T* first, const T* last, T value) {
+    std::ptrdiff_t n = 0;
+    for ( ; first != last; ++first)
+        n += ::stl::__simd_test<Op>(*first, value);
+    return n;
+}
+
+template<typename T>
+const T* __scalar_mismatch(const T* first1, const T* last1, const T* first2) {
+    while (first1 != last1 && *first1 == *first2) {
+        ++first1;
+        ++first2;
+    }
+    return first1;
+}
+
+template<typename T>
+const T* __scalar_find_pair(const T* first, const T* last, std::size_t d, T a, T b) {
+    while (first != last && !(first[0] == a && first[d] == b))
+        ++first;
+    return first;
+}
+
+#ifdef __STL_SIMD_X86
+
+// Lane operations, one struct per element type and instruction set.
+// load() and set1() give registers that cmp<Op>() turns into all-ones
+// lanes where x op value holds.  Unsigned lanes are biased by the sign bit
+// on the way in so the signed compares order them correctly.  ordered is 0
+// where the instruction set has no lane compare for <, >.
+
+template<std::size_t Size> struct __sse2_int;
+
+inline __m128i __sse2_select(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+template<> struct __sse2_int<1> {
+    enum { ordered = 1 };
+    static __m128i set1(std::int64_t x) { return _mm_set1_epi8(char(x)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+};
+
+template<> struct __sse2_int<2> {
+    enum { ordered = 1 };
+    static __m128i set1(std::int64_t x) { return _mm_set1_epi16(short(x)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+};
+
+template<> struct __sse2_int<4> {
+    enum { ordered = 1 };
+    static __m128i set1(std::int64_t x) { return _mm_set1_epi32(int(x)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+};
+
+template<> struct __sse2_int<8> {
+    enum { ordered = 0 };
+    static __m128i set1(std::int64_t x) { return _mm_set1_epi64x(x); }
+    static __m128i eq(__m128i a, __m128i b) {
+        __m128i e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, 0xB1));
+    }
+    static __m128i gt(__m128i, __m128i) { return _mm_setzero_si128(); }
+    static __m128i min(__m128i a, __m128i) { return a; }
+    static __m128i max(__m128i a, __m128i) { return a; }
+};
+
+template<typename T, bool Float = std::is_floating_point<T>::value>
+struct __sse2_lanes {
+    typedef __sse2_int<sizeof(T)> ops;
+    enum { ordered = ops::ordered };
+
+    static __m128i bias() {
+        return std::is_signed<T>::value ? _mm_setzero_si128()
+                                        : ops::set1(std::int64_t(1) << (8 * sizeof(T) - 1));
+    }
+    static __m128i load(const T* p) {
+        return _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), bias());
+    }
+    static __m128i set1(T x) { return _mm_xor_si128(ops::set1(std::int64_t(x)), bias()); }
+    static void store(T* p, __m128i x) { _mm_storeu_si128((__m128i*)p, _mm_xor_si128(x, bias())); }
+
+    static __m128i min(__m128i a, __m128i b) { return __sse2_select(ops::gt(a, b), b, a); }
+    static __m128i max(__m128i a, __m128i b) { return __sse2_select(ops::gt(a, b), a, b); }
+    static __m128i unordered(__m128i) { return _mm_setzero_si128(); }
+
+    template<int Op>
+    static __m128i cmp(__m128i x, __m128i v) {
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (Op) {
+        case __simd_eq: return ops::eq(x, v);
+        case __simd_ne: return _mm_xor_si128(ops::eq(x, v), ones);
+        case __simd_lt: return ops::gt(v, x);
+        case __simd_gt: return ops::gt(x, v);
+        case __simd_le: return _mm_xor_si128(ops::gt(x, v), ones);
+        default:        return _mm_xor_si128(ops::gt(v, x), ones);
+        }
+    }
+};
+
+template<> struct __sse2_lanes<float, true> {
+    enum { ordered = 1 };
+    static __m128i load(const float* p) { return _mm_castps_si128(_mm_loadu_ps(p)); }
+    static __m128i set1(float x) { return _mm_castps_si128(_mm_set1_ps(x)); }
+    static void store(float* p, __m128i x) { _mm_storeu_ps(p, _mm_castsi128_ps(x)); }
+
+    static __m128i min(__m128i a, __m128i b) {
+        return _mm_castps_si128(_mm_min_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    static __m128i max(__m128i a, __m128i b) {
+        return _mm_castps_si128(_mm_max_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    static __m128i unordered(__m128i x) {
+        return _mm_castps_si128(_mm_cmpunord_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(x)));
+    }
+
+    template<int Op>
+    static __m128i cmp(__m128i xi, __m128i vi) {
+        __m128 x = _mm_castsi128_ps(xi), v = _mm_castsi128_ps(vi);
+        switch (Op) {
+        case __simd_eq: return _mm_castps_si128(_mm_cmpeq_ps(x, v));
+        case __simd_ne: return _mm_castps_si128(_mm_cmpneq_ps(x, v));
+        case __simd_lt: return _mm_castps_si128(_mm_cmplt_ps(x, v));
+        case __simd_gt: return _mm_castps_si128(_mm_cmpgt_ps(x, v));
+        case __simd_le: return _mm_castps_si128(_mm_cmple_ps(x, v));
+        default:        return _mm_castps_si128(_mm_cmpge_ps(x, v));
+        }
+    }
+};
+
+template<> struct __sse2_lanes<double, true> {
+    enum { ordered = 1 };
+    static __m128i load(const double* p) { return _mm_castpd_si128(_mm_loadu_pd(p)); }
+    static __m128i set1(double x) { return _mm_castpd_si128(_mm_set1_pd(x)); }
+    static void store(double* p, __m128i x) { _mm_storeu_pd(p, _mm_castsi128_pd(x)); }
+
+    static __m128i min(__m128i a, __m128i b) {
+        return _mm_castpd_si128(_mm_min_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    static __m128i max(__m128i a, __m128i b) {
+        return _mm_castpd_si128(_mm_max_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    static __m128i unordered(__m128i x) {
+        return _mm_castpd_si128(_mm_cmpunord_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(x)));
+    }
+
+    template<int Op>
+    static __m128i cmp(__m128i xi, __m128i vi) {
+        __m128d x = _mm_castsi128_pd(xi), v = _mm_castsi128_pd(vi);
+        switch (Op) {
+        case __simd_eq: return _mm_castpd_si128(_mm_cmpeq_pd(x, v));
+        case __simd_ne: return _mm_castpd_si128(_mm_cmpneq_pd(x, v));
+        case __simd_lt: return _mm_castpd_si128(_mm_cmplt_pd(x, v));
+        case __simd_gt: return _mm_castpd_si128(_mm_cmpgt_pd(x, v));
+        case __simd_le: return _mm_castpd_si128(_mm_cmple_pd(x, v));
+        default:        return _mm_castpd_si128(_mm_cmpge_pd(x, v));
+        }
+    }
+};
+
+template<std::size_t Size> struct __avx2_int;
+
+template<> struct __avx2_int<1> {
+    __STL_TARGET_AVX2 static __m256i set1(std::int64_t x) { return _mm256_set1_epi8(char(x)); }
+    __STL_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+    __STL_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi8(a, b); }
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi8(a, b); }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi8(a, b); }
+};
+
+template<> struct __avx2_int<2> {
+    __STL_TARGET_AVX2 static __m256i set1(std::int64_t x) { return _mm256_set1_epi16(short(x)); }
+    __STL_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+    __STL_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi16(a, b); }
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi16(a, b); }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi16(a, b); }
+};
+
+template<> struct __avx2_int<4> {
+    __STL_TARGET_AVX2 static __m256i set1(std::int64_t x) { return _mm256_set1_epi32(int(x)); }
+    __STL_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+    __STL_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(a, b); }
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+};
+
+template<> struct __avx2_int<8> {
+    __STL_TARGET_AVX2 static __m256i set1(std::int64_t x) { return _mm256_set1_epi64x(x); }
+    __STL_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+    __STL_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(a, b); }
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) {
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+};
+
+template<typename T, bool Float = std::is_floating_point<T>::value>
+struct __avx2_lanes {
+    typedef __avx2_int<sizeof(T)> ops;
+
+    __STL_TARGET_AVX2 static __m256i bias() {
+        return std::is_signed<T>::value ? _mm256_setzero_si256()
+                                        : ops::set1(std::int64_t(1) << (8 * sizeof(T) - 1));
+    }
+    __STL_TARGET_AVX2 static __m256i load(const T* p) {
+        return _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)p), bias());
+    }
+    __STL_TARGET_AVX2 static __m256i set1(T x) {
+        return _mm256_xor_si256(ops::set1(std::int64_t(x)), bias());
+    }
+    __STL_TARGET_AVX2 static void store(T* p, __m256i x) {
+        _mm256_storeu_si256((__m256i*)p, _mm256_xor_si256(x, bias()));
+    }
+
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) { return ops::min(a, b); }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) { return ops::max(a, b); }
+    __STL_TARGET_AVX2 static __m256i unordered(__m256i) { return _mm256_setzero_si256(); }
+
+    template<int Op>
+    __STL_TARGET_AVX2 static __m256i cmp(__m256i x, __m256i v) {
+        const __m256i ones = _mm256_set1_epi32(-1);
+        switch (Op) {
+        case __simd_eq: return ops::eq(x, v);
+        case __simd_ne: return _mm256_xor_si256(ops::eq(x, v), ones);
+        case __simd_lt: return ops::gt(v, x);
+        case __simd_gt: return ops::gt(x, v);
+        case __simd_le: return _mm256_xor_si256(ops::gt(x, v), ones);
+        default:        return _mm256_xor_si256(ops::gt(v, x), ones);
+        }
+    }
+};
+
+template<> struct __avx2_lanes<float, true> {
+    __STL_TARGET_AVX2 static __m256i load(const float* p) {
+        return _mm256_castps_si256(_mm256_loadu_ps(p));
+    }
+    __STL_TARGET_AVX2 static __m256i set1(float x) { return _mm256_castps_si256(_mm256_set1_ps(x)); }
+    __STL_TARGET_AVX2 static void store(float* p, __m256i x) {
+        _mm256_storeu_ps(p, _mm256_castsi256_ps(x));
+    }
+
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) {
+        return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) {
+        return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+    __STL_TARGET_AVX2 static __m256i unordered(__m256i x) {
+        __m256 f = _mm256_castsi256_ps(x);
+        return _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+    }
+
+    template<int Op>
+    __STL_TARGET_AVX2 static __m256i cmp(__m256i xi, __m256i vi) {
+        __m256 x = _mm256_castsi256_ps(xi), v = _mm256_castsi256_ps(vi);
+        switch (Op) {
+        case __simd_eq: return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_EQ_OQ));
+        case __simd_ne: return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_NEQ_UQ));
+        case __simd_lt: return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_LT_OQ));
+        case __simd_gt: return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_GT_OQ));
+        case __simd_le: return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_LE_OQ));
+        default:        return _mm256_castps_si256(_mm256_cmp_ps(x, v, _CMP_GE_OQ));
+        }
+    }
+};
+
+template<> struct __avx2_lanes<double, true> {
+    __STL_TARGET_AVX2 static __m256i load(const double* p) {
+        return _mm256_castpd_si256(_mm256_loadu_pd(p));
+    }
+    __STL_TARGET_AVX2 static __m256i set1(double x) {
+        return _mm256_castpd_si256(_mm256_set1_pd(x));
+    }
+    __STL_TARGET_AVX2 static void store(double* p, __m256i x) {
+        _mm256_storeu_pd(p, _mm256_castsi256_pd(x));
+    }
+
+    __STL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+    __STL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+    __STL_TARGET_AVX2 static __m256i unordered(__m256i x) {
+        __m256d f = _mm256_castsi256_pd(x);
+        return _mm256_castpd_si256(_mm256_cmp_pd(f, f, _CMP_UNORD_Q));
+    }
+
+    template<int Op>
+    __STL_TARGET_AVX2 static __m256i cmp(__m256i xi, __m256i vi) {
+        __m256d x = _mm256_castsi256_pd(xi), v = _mm256_castsi256_pd(vi);
+        switch (Op) {
+        case __simd_eq: return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_EQ_OQ));
+        case __simd_ne: return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_NEQ_UQ));
+        case __simd_lt: return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_LT_OQ));
+        case __simd_gt: return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_GT_OQ));
+        case __simd_le: return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_LE_OQ));
+        default:        return _mm256_castpd_si256(_mm256_cmp_pd(x, v, _CMP_GE_OQ));
+        }
+    }
+};
+
+// find_if: four registers per step, one movemask test for all of them.
+template<int Op, typename T>
+const T* __sse2_find_if(const T* first, const T* last, T value) {
+    typedef __sse2_lanes<T> L;
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    const __m128i v = L::set1(value);
+    for ( ; last - first >= 4 * lanes; first += 4 * lanes) {
+        __m128i m0 = L::template cmp<Op>(L::load(first), v);
+        __m128i m1 = L::template cmp<Op>(L::load(first + lanes), v);
+        __m128i m2 = L::template cmp<Op>(L::load(first + 2 * lanes), v);
+        __m128i m3 = L::template cmp<Op>(L::load(first + 3 * lanes), v);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+            break;
+    }
+    for ( ; last - first >= lanes; first += lanes) {
+        int mask = _mm_movemask_epi8(L::template cmp<Op>(L::load(first), v));
+        if (mask)
+            return first + __builtin_ctz(mask) / sizeof(T);
+    }
+    return ::stl::__scalar_find_if<Op>(first, last, value);
+}
+
+// find_last_if: the same from the back, the highest set bit of the mask.
+template<int Op, typename T>
+const T* __sse2_find_last_if(const T* first, const T* last, T value) {
+    typedef __sse2_lanes<T> L;
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    const __m128i v = L::set1(value);
+    const T* end = last;
+    for ( ; end - first >= 4 * lanes; end -= 4 * lanes) {
+        __m128i m0 = L::template cmp<Op>(L::load(end - 4 * lanes), v);
+        __m128i m1 = L::template cmp<Op>(L::load(end - 3 * lanes), v);
+        __m128i m2 = L::template cmp<Op>(L::load(end - 2 * lanes), v);
+        __m128i m3 = L::template cmp<Op>(L::load(end - lanes), v);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+            break;
+    }
+    for ( ; end - first >= lanes; end -= lanes) {
+        int mask = _mm_movemask_epi8(L::template cmp<Op>(L::load(end - lanes), v));
+        if (mask)
+            return end - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+    }
+    const T* p = ::stl::__scalar_find_last_if<Op>(first, end, value);
+    return p == end ? last : p;
+}
+
+template<int Op, typename T>
+__STL_TARGET_AVX2 const T* __avx2_find_if(const T* first, const T* last, T value) {
+    typedef __avx2_lanes<T> L;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    const __m256i v = L::set1(value);
+    for ( ; last - first >= 4 * lanes; first += 4 * lanes) {
+        __m256i m0 = L::template cmp<Op>(L::load(first), v);
+        __m256i m1 = L::template cmp<Op>(L::load(first + lanes), v);
+        __m256i m2 = L::template cmp<Op>(L::load(first + 2 * lanes), v);
+        __m256i m3 = L::template cmp<Op>(L::load(first + 3 * lanes), v);
+        if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3)),
+                                _mm256_set1_epi32(-1)))
+            break;
+    }
+    for ( ; last - first >= lanes; first += lanes) {
+        unsigned mask = unsigned(_mm256_movemask_epi8(L::template cmp<Op>(L::load(first), v)));
+        if (mask)
+            return first + __builtin_ctz(mask) / sizeof(T);
+    }
+    return ::stl::__scalar_find_if<Op>(first, last, value);
+}
+
+template<int Op, typename T>
+__STL_TARGET_AVX2 const T* __avx2_find_last_if(const T* first, const T* last, T value) {
+    typedef __avx2_lanes<T> L;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    const __m256i v = L::set1(value);
+    const T* end = last;
+    for ( ; end - first >= 4 * lanes; end -= 4 * lanes) {
+        __m256i m0 = L::template cmp<Op>(L::load(end - 4 * lanes), v);
+        __m256i m1 = L::template cmp<Op>(L::load(end - 3 * lanes), v);
+        __m256i m2 = L::template cmp<Op>(L::load(end - 2 * lanes), v);
+        __m256i m3 = L::template cmp<Op>(L::load(end - lanes), v);
+        if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3)),
+                                _mm256_set1_epi32(-1)))
+            break;
+    }
+    for ( ; end - first >= lanes; end -= lanes) {
+        unsigned mask = unsigned(_mm256_movemask_epi8(L::template cmp<Op>(L::load(end - lanes), v)));
+        if (mask)
+            return end - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+    }
+    const T* p = ::stl::__scalar_find_last_if<Op>(first, end, value);
+    return p == end ? last : p;
+}
+
+// count_if: matching lanes are all ones, so subtracting the masks counts
+// matching bytes in each byte of two accumulators.  They are folded into
+// 64-bit sums with psadbw before any byte can pass 255, and the total is
+// divided by the lane width at the end.
+template<int Op, typename T>
+std::ptrdiff_t __sse2_count_if(const T* first, const T* last, T value) {
+    typedef __sse2_lanes<T> L;
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    const __m128i v = L::set1(value);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    while (last - first >= lanes) {
+        __m128i bytes0 = zero, bytes1 = zero;
+        int i = 0;
+        for ( ; i < 63 && last - first >= 4 * lanes; ++i, first += 4 * lanes) {
+            bytes0 = _mm_sub_epi8(bytes0, L::template cmp<Op>(L::load(first), v));
+            bytes1 = _mm_sub_epi8(bytes1, L::template cmp<Op>(L::load(first + lanes), v));
+            bytes0 = _mm_sub_epi8(bytes0, L::template cmp<Op>(L::load(first + 2 * lanes), v));
+            bytes1 = _mm_sub_epi8(bytes1, L::template cmp<Op>(L::load(first + 3 * lanes), v));
+        }
+        if (i == 0)
+            for ( ; last - first >= lanes; first += lanes)
+                bytes0 = _mm_sub_epi8(bytes0, L::template cmp<Op>(L::load(first), v));
+        total = _mm_add_epi64(total, _mm_add_epi64(_mm_sad_epu8(bytes0, zero),
+                                                   _mm_sad_epu8(bytes1, zero)));
+    }
+    std::ptrdiff_t n = std::ptrdiff_t(_mm_cvtsi128_si64(total)
+                                      + _mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total)));
+    return n / sizeof(T) + ::stl::__scalar_count_if<Op>(first, last, value);
+}
+
+template<int Op, typename T>
+__STL_TARGET_AVX2 std::ptrdiff_t __avx2_count_if(const T* first, const T* last, T value) {
+    typedef __avx2_lanes<T> L;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    const __m256i v = L::set1(value);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    while (last - first >= lanes) {
+        __m256i bytes0 = zero, bytes1 = zero;
+        int i = 0;
+        for ( ; i < 63 && last - first >= 4 * lanes; ++i, first += 4 * lanes) {
+            bytes0 = _mm256_sub_epi8(bytes0, L::template cmp<Op>(L::load(first), v));
+            bytes1 = _mm256_sub_epi8(bytes1, L::template cmp<Op>(L::load(first + lanes), v));
+            bytes0 = _mm256_sub_epi8(bytes0, L::template cmp<Op>(L::load(first + 2 * lanes), v));
+            bytes1 = _mm256_sub_epi8(bytes1, L::template cmp<Op>(L::load(first + 3 * lanes), v));
+        }
+        if (i == 0)
+            for ( ; last - first >= lanes; first += lanes)
+                bytes0 = _mm256_sub_epi8(bytes0, L::template cmp<Op>(L::load(first), v));
+        total = _mm256_add_epi64(total, _mm256_add_epi64(_mm256_sad_epu8(bytes0, zero),
+                                                         _mm256_sad_epu8(bytes1, zero)));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(total),
+                                _mm256_extracti128_si256(total, 1));
+    std::ptrdiff_t n = std::ptrdiff_t(_mm_cvtsi128_si64(sum)
+                                      + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sum, sum)));
+    return n / sizeof(T) + ::stl::__scalar_count_if<Op>(first, last, value);
+}
+
+// min/max reduction: lane-wise minimum and maximum over the range in four
+// independent accumulators, then across the lanes.  Gives up (returns
+// false) on a NaN, whose ordering the vector min/max does not share with
+// operator<; the caller then runs the plain loop.
+template<bool Min, bool Max, typename T>
+inline bool __scalar_minmax_tail(const T* first, const T* last, T& mn, T& mx) {
+    for ( ; first != last; ++first) {
+        if (*first != *first)
+            return false;
+        if (Min && *first < mn) mn = *first;
+        if (Max && mx < *first) mx = *first;
+    }
+    return true;
+}
+
+template<bool Min, bool Max, typename T>
+bool __sse2_minmax(const T* first, const T* last, T& mn, T& mx) {
+    typedef __sse2_lanes<T> L;
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    mn = mx = *first;
+    if (last - first >= lanes) {
+        __m128i vmin = L::load(first), vmax = vmin, nan = L::unordered(vmin);
+        __m128i vmin1 = vmin, vmax1 = vmin, vmin2 = vmin, vmax2 = vmin, vmin3 = vmin, vmax3 = vmin;
+        for (first += lanes; last - first >= 4 * lanes; first += 4 * lanes) {
+            __m128i x0 = L::load(first), x1 = L::load(first + lanes);
+            __m128i x2 = L::load(first + 2 * lanes), x3 = L::load(first + 3 * lanes);
+            if (Min) {
+                vmin = L::min(vmin, x0); vmin1 = L::min(vmin1, x1);
+                vmin2 = L::min(vmin2, x2); vmin3 = L::min(vmin3, x3);
+            }
+            if (Max) {
+                vmax = L::max(vmax, x0); vmax1 = L::max(vmax1, x1);
+                vmax2 = L::max(vmax2, x2); vmax3 = L::max(vmax3, x3);
+            }
+            nan = _mm_or_si128(nan, _mm_or_si128(_mm_or_si128(L::unordered(x0), L::unordered(x1)),
+                                                 _mm_or_si128(L::unordered(x2), L::unordered(x3))));
+        }
+        vmin = L::min(L::min(vmin, vmin1), L::min(vmin2, vmin3));
+        vmax = L::max(L::max(vmax, vmax1), L::max(vmax2, vmax3));
+        for ( ; last - first >= lanes; first += lanes) {
+            __m128i x = L::load(first);
+            if (Min) vmin = L::min(vmin, x);
+            if (Max) vmax = L::max(vmax, x);
+            nan = _mm_or_si128(nan, L::unordered(x));
+        }
+        if (_mm_movemask_epi8(nan))
+            return false;
+        T buf[16 / sizeof(T)];
+        L::store(buf, vmin);
+        if (Min && !::stl::__scalar_minmax_tail<true, false>(buf, buf + lanes, mn, mx)) return false;
+        L::store(buf, vmax);
+        if (Max && !::stl::__scalar_minmax_tail<false, true>(buf, buf + lanes, mn, mx)) return false;
+    }
+    return ::stl::__scalar_minmax_tail<Min, Max>(first, last, mn, mx);
+}
+
+template<bool Min, bool Max, typename T>
+__STL_TARGET_AVX2 bool __avx2_minmax(const T* first, const T* last, T& mn, T& mx) {
+    typedef __avx2_lanes<T> L;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    mn = mx = *first;
+    if (last - first >= lanes) {
+        __m256i vmin = L::load(first), vmax = vmin, nan = L::unordered(vmin);
+        __m256i vmin1 = vmin, vmax1 = vmin, vmin2 = vmin, vmax2 = vmin, vmin3 = vmin, vmax3 = vmin;
+        for (first += lanes; last - first >= 4 * lanes; first += 4 * lanes) {
+            __m256i x0 = L::load(first), x1 = L::load(first + lanes);
+            __m256i x2 = L::load(first + 2 * lanes), x3 = L::load(first + 3 * lanes);
+            if (Min) {
+                vmin = L::min(vmin, x0); vmin1 = L::min(vmin1, x1);
+                vmin2 = L::min(vmin2, x2); vmin3 = L::min(vmin3, x3);
+            }
+            if (Max) {
+                vmax = L::max(vmax, x0); vmax1 = L::max(vmax1, x1);
+                vmax2 = L::max(vmax2, x2); vmax3 = L::max(vmax3, x3);
+            }
+            nan = _mm256_or_si256(nan,
+                                  _mm256_or_si256(_mm256_or_si256(L::unordered(x0), L::unordered(x1)),
+                                                  _mm256_or_si256(L::unordered(x2), L::unordered(x3))));
+        }
+        vmin = L::min(L::min(vmin, vmin1), L::min(vmin2, vmin3));
+        vmax = L::max(L::max(vmax, vmax1), L::max(vmax2, vmax3));
+        for ( ; last - first >= lanes; first += lanes) {
+            __m256i x = L::load(first);
+            if (Min) vmin = L::min(vmin, x);
+            if (Max) vmax = L::max(vmax, x);
+            nan = _mm256_or_si256(nan, L::unordered(x));
+        }
+        if (!_mm256_testz_si256(nan, nan))
+            return false;
+        T buf[32 / sizeof(T)];
+        L::store(buf, vmin);
+        if (Min && !::stl::__scalar_minmax_tail<true, false>(buf, buf + lanes, mn, mx)) return false;
+        L::store(buf, vmax);
+        if (Max && !::stl::__scalar_minmax_tail<false, true>(buf, buf + lanes, mn, mx)) return false;
+    }
+    return ::stl::__scalar_minmax_tail<Min, Max>(first, last, mn, mx);
+}
+
+// mismatch: the find_if loop with the second range loaded in place of the
+// broadcast value.
+template<typename T>
+const T* __sse2_mismatch(const T* first1, const T* last1, const T* first2) {
+    typedef __sse2_lanes<T> L;
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    for ( ; last1 - first1 >= 4 * lanes; first1 += 4 * lanes, first2 += 4 * lanes) {
+        __m128i m0 = L::template cmp<__simd_ne>(L::load(first1), L::load(first2));
+        __m128i m1 = L::template cmp<__simd_ne>(L::load(first1 + lanes), L::load(first2 + lanes));
+        __m128i m2 = L::template cmp<__simd_ne>(L::load(first1 + 2 * lanes),
+                                                L::load(first2 + 2 * lanes));
+        __m128i m3 = L::template cmp<__simd_ne>(L::load(first1 + 3 * lanes),
+                                                L::load(first2 + 3 * lanes));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+            break;
+    }
+    for ( ; last1 - first1 >= lanes; first1 += lanes, first2 += lanes) {
+        int mask = _mm_movemask_epi8(L::template cmp<__simd_ne>(L::load(first1), L::load(first2)));
+        if (mask)
+            return first1 + __builtin_ctz(mask) / sizeof(T);
+    }
+    return ::stl::__scalar_mismatch(first1, last1, first2);
+}
+
+template<typename T>
+__STL_TARGET_AVX2 const T* __avx2_mismatch(const T* first1, const T* last1, const T* first2) {
+    typedef __avx2_lanes<T> L;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    for ( ; last1 - first1 >= 4 * lanes; first1 += 4 * lanes, first2 += 4 * lanes) {
+        __m256i m0 = L::template cmp<__simd_ne>(L::load(first1), L::load(first2));
+        __m256i m1 = L::template cmp<__simd_ne>(L::load(first1 + lanes), L::load(first2 + lanes));
+        __m256i m2 = L::template cmp<__simd_ne>(L::load(first1 + 2 * lanes),
+                                                L::load(first2 + 2 * lanes));
+        __m256i m3 = L::template cmp<__simd_ne>(L::load(first1 + 3 * lanes),
+                                                L::load(first2 + 3 * lanes));
+        if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3)),
+                                _mm256_set1_epi32(-1)))
+            break;
+    }
+    for ( ; last1 - first1 >= lanes; first1 += lanes, first2 += lanes) {
+        unsigned mask = unsigned(_mm256_movemask_epi8(
+            L::template cmp<__simd_ne>(L::load(first1), L::load(first2))));
+        if (mask)
+            return first1 + __builtin_ctz(mask) / sizeof(T);
+    }
+    return ::stl::__scalar_mismatch(first1, last1, first2);
+}
+
+// fill: the element's bytes broadcast to a register and stored four
+// registers per step, the last one overlapping the end of the range.
+// Size divides the register width, so every store starts on an element.
+// A streaming fill aligns the stores after the first one and issues
+// non-temporal stores, fenced before returning.
+template<std::size_t Size>
+void __sse2_fill(char* first, char* last, std::int64_t bits, bool stream) {
+    const __m128i v = __sse2_int<Size>::set1(bits);
+    char* end = last - 16;
+    if (stream) {
+        _mm_storeu_si128((__m128i*)first, v);
+        first += -reinterpret_cast<std::uintptr_t>(first) & 15;
+        for ( ; last - first >= 64; first += 64) {
+            _mm_stream_si128((__m128i*)first, v);
+            _mm_stream_si128((__m128i*)(first + 16), v);
+            _mm_stream_si128((__m128i*)(first + 32), v);
+            _mm_stream_si128((__m128i*)(first + 48), v);
+        }
+        _mm_sfence();
+    }
+    for ( ; last - first >= 64; first += 64) {
+        _mm_storeu_si128((__m128i*)first, v);
+        _mm_storeu_si128((__m128i*)(first + 16), v);
+        _mm_storeu_si128((__m128i*)(first + 32), v);
+        _mm_storeu_si128((__m128i*)(first + 48), v);
+    }
+    for ( ; last - first >= 16; first += 16)
+        _mm_storeu_si128((__m128i*)first, v);
+    if (first != last)
+        _mm_storeu_si128((__m128i*)end, v);
+}
+
+template<std::size_t Size>
+__STL_TARGET_AVX2 void __avx2_fill(char* first, char* last, std::int64_t bits, bool stream) {
+    const __m256i v = __avx2_int<Size>::set1(bits);
+    char* end = last - 32;
+    if (stream) {
+        _mm256_storeu_si256((__m256i*)first, v);
+        first += -reinterpret_cast<std::uintptr_t>(first) & 31;
+        for ( ; last - first >= 128; first += 128) {
+            _mm256_stream_si256((__m256i*)first, v);
+            _mm256_stream_si256((__m256i*)(first + 32), v);
+            _mm256_stream_si256((__m256i*)(first + 64), v);
+            _mm256_stream_si256((__m256i*)(first + 96), v);
+        }
+        _mm_sfence();
+    }
+    for ( ; last - first >= 128; first += 128) {
+        _mm256_storeu_si256((__m256i*)first, v);
+        _mm256_storeu_si256((__m256i*)(first + 32), v);
+        _mm256_storeu_si256((__m256i*)(first + 64), v);
+        _mm256_storeu_si256((__m256i*)(first + 96), v);
+    }
+    for ( ; last - first >= 32; first += 32)
+        _mm256_storeu_si256((__m256i*)first, v);
+    if (first != last)
+        _mm256_storeu_si256((__m256i*)end, v);
+}
+
+// Streaming copy between disjoint ranges of n >= 2 * width bytes: one
+// unaligned store to align the destination, then unaligned loads and
+// non-temporal stores four registers at a time, the rest through memcpy().
+inline void __sse2_stream_copy(char* result, const char* first, std::size_t n) {
+    _mm_storeu_si128((__m128i*)result, _mm_loadu_si128((const __m128i*)first));
+    std::size_t head = -reinterpret_cast<std::uintptr_t>(result) & 15;
+    result += head;
+    first += head;
+    n -= head;
+    for ( ; n >= 64; n -= 64, first += 64, result += 64) {
+        __m128i x0 = _mm_loadu_si128((const __m128i*)first);
+        __m128i x1 = _mm_loadu_si128((const __m128i*)(first + 16));
+        __m128i x2 = _mm_loadu_si128((const __m128i*)(first + 32));
+        __m128i x3 = _mm_loadu_si128((const __m128i*)(first + 48));
+        _mm_stream_si128((__m128i*)result, x0);
+        _mm_stream_si128((__m128i*)(result + 16), x1);
+        _mm_stream_si128((__m128i*)(result + 32), x2);
+        _mm_stream_si128((__m128i*)(result + 48), x3);
+    }
+    _mm_sfence();
+    std::memcpy(result, first, n);
+}
+
+__STL_TARGET_AVX2 inline void __avx2_stream_copy(char* result, const char* first, std::size_t n) {
+    _mm256_storeu_si256((__m256i*)result, _mm256_loadu_si256((const __m256i*)first));
+    std::size_t head = -reinterpret_cast<std::uintptr_t>(result) & 31;
+    result += head;
+    first += head;
+    n -= head;
+    for ( ; n >= 128; n -= 128, first += 128, result += 128) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i*)first);
+        __m256i x1 = _mm256_loadu_si256((const __m256i*)(first + 32));
+        __m256i x2 = _mm256_loadu_si256((const __m256i*)(first + 64));
+        __m256i x3 = _mm256_loadu_si256((const __m256i*)(first + 96));
+        _mm256_stream_si256((__m256i*)result, x0);
+        _mm256_stream_si256((__m256i*)(result + 32), x1);
+        _mm256_stream_si256((__m256i*)(result + 64), x2);
+        _mm256_stream_si256((__m256i*)(result + 96), x3);
+    }
+    _mm_sfence();
+    std::memcpy(result, first, n);
+}
+
+// Pair filter for substring search over bytes: the first p in
+// [first, last) with p[0] == a and p[d] == b, a register of positions at
+// a time; reads up to last - 1 + d.  The search proper checks each such
+// candidate with memcmp().
+template<typename T>
+const T* __sse2_find_pair(const T* first, const T* last, std::size_t d, T a, T b) {
+    const __m128i va = _mm_set1_epi8(char(a));
+    const __m128i vb = _mm_set1_epi8(char(b));
+    for ( ; last - first >= 16; first += 16) {
+        __m128i x = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)first), va);
+        __m128i y = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(first + d)), vb);
+        int mask = _mm_movemask_epi8(_mm_and_si128(x, y));
+        if (mask)
+            return first + __builtin_ctz(mask);
+    }
+    return ::stl::__scalar_find_pair(first, last, d, a, b);
+}
+
+template<typename T>
+const T* __sse2_search_bytes(const T* first, const T* last, const T* needle, std::size_t m) {
+    for (const T* end = last - (m - 1); ; ++first) {
+        first = ::stl::__sse2_find_pair(first, end, m - 1, needle[0], needle[m - 1]);
+        if (first == end)
+            return last;
+        if (std::memcmp(first + 1, needle + 1, m - 2) == 0)
+            return first;
+    }
+}
+
+template<typename T>
+__STL_TARGET_AVX2 const T* __avx2_find_pair(const T* first, const T* last, std::size_t d,
+                                            T a, T b) {
+    const __m256i va = _mm256_set1_epi8(char(a));
+    const __m256i vb = _mm256_set1_epi8(char(b));
+    for ( ; last - first >= 32; first += 32) {
+        __m256i x = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)first), va);
+        __m256i y = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(first + d)), vb);
+        unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_and_si256(x, y)));
+        if (mask)
+            return first + __builtin_ctz(mask);
+    }
+    return ::stl::__scalar_find_pair(first, last, d, a, b);
+}
+
+template<typename T>
+__STL_TARGET_AVX2 const T* __avx2_search_bytes(const T* first, const T* last, const T* needle,
+                                               std::size_t m) {
+    for (const T* end = last - (m - 1); ; ++first) {
+        first = ::stl::__avx2_find_pair(first, end, m - 1, needle[0], needle[m - 1]);
+        if (first == end)
+            return last;
+        if (std::memcmp(first + 1, needle + 1, m - 2) == 0)
+            return first;
+    }
+}
+
+#endif /* __STL_SIMD_X86 */
+
+template<int Op, typename T>
+inline const T* __simd_find_if(const T* first, const T* last, T value) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2)
+        return ::stl::__avx2_find_if<Op>(first, last, value);
+    if (level >= __simd_sse2
+        && (__sse2_lanes<T>::ordered || Op == __simd_eq || Op == __simd_ne))
+        return ::stl::__sse2_find_if<Op>(first, last, value);
+#endif
+    return ::stl::__scalar_find_if<Op>(first, last, value);
+}
+
+template<int Op, typename T>
+inline const T* __simd_find_last_if(const T* first, const T* last, T value) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2)
+        return ::stl::__avx2_find_last_if<Op>(first, last, value);
+    if (level >= __simd_sse2
+        && (__sse2_lanes<T>::ordered || Op == __simd_eq || Op == __simd_ne))
+        return ::stl::__sse2_find_last_if<Op>(first, last, value);
+#endif
+    return ::stl::__scalar_find_last_if<Op>(first, last, value);
+}
+
+template<int Op, typename T>
+inline std::ptrdiff_t __simd_count_if(const T* first, const T* last, T value) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2)
+        return ::stl::__avx2_count_if<Op>(first, last, value);
+    if (level >= __simd_sse2
+        && (__sse2_lanes<T>::ordered || Op == __simd_eq || Op == __simd_ne))
+        return ::stl::__sse2_count_if<Op>(first, last, value);
+#endif
+    return ::stl::__scalar_count_if<Op>(first, last, value);
+}
+
+// The smallest and/or largest value of the non-empty [first, last).
+// Returns false when there is no kernel for T at this level, or on a NaN.
+template<bool Min, bool Max, typename T>
+inline bool __simd_minmax(const T* first, const T* last, T& mn, T& mx) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2)
+        return ::stl::__avx2_minmax<Min, Max>(first, last, mn, mx);
+    if (level >= __simd_sse2 && __sse2_lanes<T>::ordered)
+        return ::stl::__sse2_minmax<Min, Max>(first, last, mn, mx);
+#endif
+    (void)first; (void)last; (void)mn; (void)mx;
+    return false;
+}
+
+// The first position in [first1, last1) whose element does not compare
+// equal to its counterpart from first2.
+template<typename T>
+inline const T* __simd_mismatch(const T* first1, const T* last1, const T* first2) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2)
+        return ::stl::__avx2_mismatch(first1, last1, first2);
+    if (level >= __simd_sse2)
+        return ::stl::__sse2_mismatch(first1, last1, first2);
+#endif
+    return ::stl::__scalar_mismatch(first1, last1, first2);
+}
+
+// The pair filter, for levels of at least __simd_sse2.
+template<typename T>
+inline const T* __simd_find_pair(const T* first, const T* last, std::size_t d, T a, T b) {
+#ifdef __STL_SIMD_X86
+    if (::stl::__simd_level() >= __simd_avx2)
+        return ::stl::__avx2_find_pair(first, last, d, a, b);
+    return ::stl::__sse2_find_pair(first, last, d, a, b);
+#else
+    return ::stl::__scalar_find_pair(first, last, d, a, b);
+#endif
+}
+
+// The first occurrence of the m >= 2 bytes at needle in [first, last),
+// where last - first >= m, or last.  Returns false when there is no kernel
+// at this level.
+template<typename T>
+inline bool __simd_search_bytes(const T* first, const T* last, const T* needle, std::size_t m,
+                                const T*& result) {
+#ifdef __STL_SIMD_X86
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2) {
+        result = ::stl::__avx2_search_bytes(first, last, needle, m);
+        return true;
+    }
+    if (level >= __simd_sse2) {
+        result = ::stl::__sse2_search_bytes(first, last, needle, m);
+        return true;
+    }
+#endif
+    (void)first; (void)last; (void)needle; (void)m; (void)result;
+    return false;
+}
+
+// Stores value to every element of [first, last).  T is trivially
+// copyable and 1, 2, 4 or 8 bytes wide.  A value made of one repeated byte,
+// zero most of all, is a memset(), which also streams large fills itself.
+template<typename T>
+void __simd_fill(T* first, T* last, T value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    std::size_t i = 1;
+    while (i < sizeof(T) && bytes[i] == bytes[0])
+        ++i;
+    std::size_t n = std::size_t(last - first) * sizeof(T);
+    if (i == sizeof(T)) {
+        if (n != 0)
+            std::memset(first, bytes[0], n);
+        return;
+    }
+#ifdef __STL_SIMD_X86
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    char* p = reinterpret_cast<char*>(first);
+    bool stream = n >= ::stl::__simd_stream_threshold()
+                  && reinterpret_cast<std::uintptr_t>(p) % sizeof(T) == 0;
+    int level = ::stl::__simd_level();
+    if (level >= __simd_avx2 && n >= 32) {
+        ::stl::__avx2_fill<sizeof(T)>(p, p + n, std::int64_t(bits), stream);
+        return;
+    }
+    if (level >= __simd_sse2 && n >= 16) {
+        ::stl::__sse2_fill<sizeof(T)>(p, p + n, std::int64_t(bits), stream);
+        return;
+    }
+#endif
+    for ( ; first != last; ++first)
+        *first = value;
+}
+
+// The copy engine behind copy() and uninitialized_copy() of trivially
+// copyable types: memmove(), or with stream set, non-temporal stores when
+// the ranges do not overlap.
+inline void __copy_bytes(void* result, const void* first, std::size_t n, bool stream) {
+#ifdef __STL_SIMD_X86
+    char* d = static_cast<char*>(result);
+    const char* s = static_cast<const char*>(first);
+    if (stream && n >= 256 && (d + n <= s || s + n <= d)) {
+        int level = ::stl::__simd_level();
+        if (level >= __simd_avx2) {
+            ::stl::__avx2_stream_copy(d, s, n);
+            return;
+        }
+        if (level >= __simd_sse2) {
+            ::stl::__sse2_stream_copy(d, s, n);
+            return;
+        }
+    }
+#endif
+    (void)stream;
+    if (n != 0)
+        std::memmove(result, first, n);
+}
+
+inline void __copy_bytes(void* result, const void* first, std::size_t n) {
+    ::stl::__copy_bytes(result, first, n, n >= ::stl::__simd_stream_threshold());
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_SIMD_ */
@@ -0,0 +1,84 @@
+#ifndef STL_IMPL_TEMPBUF_
+#define STL_IMPL_TEMPBUF_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include "__type_traits.hpp"
+#include "utility.hpp"
+#include "memory/utils.hpp"
+
+namespace stl {
+
+// Scratch memory for the algorithms that run faster with a buffer
+// (radix_sort, inplace_merge, stable_sort).  Asks for len elements and
+// halves the request until malloc succeeds; the caller must cope with
+// whatever it gets, including nothing.
+template<typename T>
+pair<T*, std::ptrdiff_t> get_temporary_buffer(std::ptrdiff_t len) {
+    if (len > std::ptrdiff_t(PTRDIFF_MAX / sizeof(T)))
+        len = PTRDIFF_MAX / sizeof(T);
+    while (len > 0) {
+        T* p = (T*)std::malloc(len * sizeof(T));
+        if (p)
+            return pair<T*, std::ptrdiff_t>(p, len);
+        len /= 2;
+    }
+    return pair<T*, std::ptrdiff_t>((T*)0, 0);
+}
+
+template<typename T>
+inline void return_temporary_buffer(T* p) {
+    std::free(p);
+}
+
+// A temporary buffer for len elements like *first.  Elements of non-trivial
+// types are constructed as copies of *first so the algorithms can simply
+// assign into the buffer; trivial ones are left uninitialized.
+template<typename ForwardIterator, typename T>
+class __temporary_buffer {
+private:
+    std::ptrdiff_t original_len;
+    std::ptrdiff_t len;
+    T* buffer;
+
+    void initialize_buffer(const T&, __true_type) { }
+    void initialize_buffer(const T& value, __false_type) {
+        memory::uninitialized_fill_n(buffer, len, value);
+    }
+
+public:
+    __temporary_buffer(ForwardIterator first, std::ptrdiff_t n) : buffer(0) {
+        typedef typename __type_traits<T>::has_trivial_default_constructor trivial;
+        original_len = n;
+        pair<T*, std::ptrdiff_t> p = stl::get_temporary_buffer<T>(original_len);
+        buffer = p.first;
+        len = p.second;
+        try {
+            if (len > 0)
+                initialize_buffer(*first, trivial());
+        }
+        catch (...) {
+            stl::return_temporary_buffer(buffer);
+            buffer = 0;
+            len = 0;
+            throw;
+        }
+    }
+    ~__temporary_buffer() {
+        memory::destroy(buffer, buffer + len);
+        stl::return_temporary_buffer(buffer);
+    }
+
+    __temporary_buffer(const __temporary_buffer&) = delete;
+    __temporary_buffer& operator=(const __temporary_buffer&) = delete;
+
+    std::ptrdiff_t size() const { return len; }
+    std::ptrdiff_t requested_size() const { return original_len; }
+    T* begin() { return buffer; }
+    T* end() { return buffer + len; }
+};
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_TEMPBUF_ */
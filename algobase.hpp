@@ -5,21 +5,74 @@
 #include <functional>
 #include <utility>
 #include <cstring>
+#include <type_traits>
 #include "__type_traits.hpp"
+#include "__simd.hpp"
 #include "utility.hpp"
 
 namespace stl {
 
+// How two contiguous ranges of T and U can be compared in bulk.  Integers
+// compare equal exactly when their bytes do; memcmp() also orders unsigned
+// bytes the way operator< does.  Other arithmetic types go through the
+// vector mismatch, which keeps NaN != NaN and 0.0 == -0.0.
+template<typename T, typename U>
+struct __contiguous_compare {
+    typedef typename std::remove_cv<T>::type V;
+    enum { same = std::is_same<V, typename std::remove_cv<U>::type>::value };
+    enum { bytewise = same && std::is_integral<V>::value };
+    enum { byte_ordered = bytewise && sizeof(V) == 1 && std::is_unsigned<V>::value };
+    enum { vectorizable = same && __simd_traits<V>::value };
+
+    typedef typename std::conditional<bytewise, __traits::__true_type,
+                                      __traits::__false_type>::type is_bytewise;
+    typedef typename std::conditional<byte_ordered, __traits::__true_type,
+                                      __traits::__false_type>::type is_byte_ordered;
+    typedef typename std::conditional<vectorizable, __traits::__true_type,
+                                      __traits::__false_type>::type is_vectorizable;
+};
+
 // Equal
 template<typename InputIterator1, typename InputIterator2>
-inline bool equal(InputIterator1 first1, InputIterator1 last1,
-                  InputIterator2 first2) {
+inline bool __equal(InputIterator1 first1, InputIterator1 last1,
+                    InputIterator2 first2) {
     for ( ; first1 != last1; ++first1, ++first2)
         if (*first1 != *first2)
             return false;
     return true;
 }
 
+template<typename T, typename U, typename Vectorizable>
+inline bool __equal_contiguous(T* first1, T* last1, U* first2,
+                               stl::__traits::__true_type, Vectorizable) {
+    return first1 == last1 || std::memcmp(first1, first2, sizeof(T) * (last1 - first1)) == 0;
+}
+
+template<typename T, typename U>
+inline bool __equal_contiguous(T* first1, T* last1, U* first2,
+                               stl::__traits::__false_type, stl::__traits::__true_type) {
+    return ::stl::__simd_mismatch<typename std::remove_cv<T>::type>(first1, last1, first2) == last1;
+}
+
+template<typename T, typename U>
+inline bool __equal_contiguous(T* first1, T* last1, U* first2,
+                               stl::__traits::__false_type, stl::__traits::__false_type) {
+    return ::stl::__equal<T*, U*>(first1, last1, first2);
+}
+
+template<typename T, typename U>
+inline bool __equal(T* first1, T* last1, U* first2) {
+    typedef __contiguous_compare<T, U> traits;
+    return ::stl::__equal_contiguous(first1, last1, first2, typename traits::is_bytewise(),
+                                     typename traits::is_vectorizable());
+}
+
+template<typename InputIterator1, typename InputIterator2>
+inline bool equal(InputIterator1 first1, InputIterator1 last1,
+                  InputIterator2 first2) {
+    return ::stl::__equal(first1, last1, first2);
+}
+
 template<typename InputIterator1, typename InputIterator2, typename BinaryOperation>
 inline bool equal(InputIterator1 first1, InputIterator1 last1,
                   InputIterator2 first2, BinaryOperation binary_op) {
@@ -30,19 +83,87 @@ inline bool equal(InputIterator1 first1, InputIterator1 last1,
 }
 
 // Fill
+// A contiguous range of T is filled in bulk when T is trivially copyable
+// and 1, 2, 4 or 8 bytes wide, and storing value is copying the bytes of a
+// T: value is a T, or T is a scalar that value converts to.
+template<typename T, typename U>
+struct __fill_traits {
+    enum { value = !std::is_const<T>::value && !std::is_volatile<T>::value
+                   && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+                   && std::is_trivially_copyable<T>::value
+                   && (std::is_same<T, typename std::remove_cv<U>::type>::value
+                       || std::is_scalar<T>::value) };
+    typedef typename std::conditional<value, __traits::__true_type,
+                                      __traits::__false_type>::type is_vectorizable;
+};
+
 template<typename ForwardIterator, typename T>
-void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+inline void __fill(ForwardIterator first, ForwardIterator last, const T& value,
+                   stl::__traits::__false_type) {
     for ( ; first != last; ++first)
         *first = value;
 }
 
+template<typename T, typename U>
+inline void __fill_contiguous(T* first, T* last, const U& value, stl::__traits::__true_type) {
+    T tmp = value;
+    ::stl::__simd_fill(first, last, tmp);
+}
+
+template<typename T, typename U>
+inline void __fill_contiguous(T* first, T* last, const U& value, stl::__traits::__false_type) {
+    for ( ; first != last; ++first)
+        *first = value;
+}
+
+template<typename T, typename U>
+inline void __fill(T* first, T* last, const U& value, stl::__traits::__false_type) {
+    ::stl::__fill_contiguous(first, last, value,
+                             typename __fill_traits<T, U>::is_vectorizable());
+}
+
+template<typename SegmentedIterator, typename T>
+void __fill(SegmentedIterator first, SegmentedIterator last, const T& value,
+            stl::__traits::__true_type) {
+    typedef stl::__segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast) {
+        __fill(traits::local(first), traits::local(last), value, stl::__traits::__false_type());
+        return ;
+    }
+    __fill(traits::local(first), traits::end(sfirst), value, stl::__traits::__false_type());
+    for (++sfirst; sfirst != slast; ++sfirst)
+        __fill(traits::begin(sfirst), traits::end(sfirst), value, stl::__traits::__false_type());
+    __fill(traits::begin(slast), traits::local(last), value, stl::__traits::__false_type());
+}
+
+template<typename ForwardIterator, typename T>
+inline void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+    typedef typename stl::__segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+    __fill(first, last, value, segmented());
+}
+
 template<typename OutputIterator, typename Size, typename T>
-void fill_n(OutputIterator first, Size n, const T& value) {
+inline OutputIterator __fill_n(OutputIterator first, Size n, const T& value) {
     for ( ; n > 0; --n, ++first)
         *first = value;
     return first;
 }
 
+template<typename T, typename Size, typename U>
+inline T* __fill_n(T* first, Size n, const U& value) {
+    if (n <= 0)
+        return first;
+    ::stl::__fill(first, first + n, value, stl::__traits::__false_type());
+    return first + n;
+}
+
+template<typename OutputIterator, typename Size, typename T>
+inline OutputIterator fill_n(OutputIterator first, Size n, const T& value) {
+    return ::stl::__fill_n(first, n, value);
+}
+
 // Iterator swap
 template<typename ForwardIterator1, typename ForwardIterator2, typename T>
 inline void __iter_swap(ForwardIterator1 a, ForwardIterator2 b, T*) {
@@ -58,8 +179,8 @@ inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b) {
 
 // Lexicographical compare
 template<typename InputIterator1, typename InputIterator2>
-bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
-                             InputIterator2 first2, InputIterator2 last2) {
+bool __lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+                               InputIterator2 first2, InputIterator2 last2) {
     for ( ; first1 != last1 && first2 != last2; ++first1, ++first2) {
         if (*first1 < *first2)
             return true;
@@ -69,6 +190,59 @@ bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
     return first1 == last1 && first2 != last2;
 }
 
+template<typename T, typename U, typename Vectorizable>
+inline bool __lexicographical_compare_contiguous(T* first1, T* last1, U* first2, U* last2,
+                                                 stl::__traits::__true_type, Vectorizable) {
+    std::ptrdiff_t len1 = last1 - first1, len2 = last2 - first2;
+    std::ptrdiff_t n = len1 < len2 ? len1 : len2;
+    int result = n == 0 ? 0 : std::memcmp(first1, first2, n);
+    return result != 0 ? result < 0 : len1 < len2;
+}
+
+// Skips the equal prefix with the vector mismatch; elements that differ
+// but are unordered (NaN) are skipped like the plain loop does.
+template<typename T, typename U>
+bool __lexicographical_compare_contiguous(T* first1, T* last1, U* first2, U* last2,
+                                          stl::__traits::__false_type,
+                                          stl::__traits::__true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    std::ptrdiff_t len1 = last1 - first1, len2 = last2 - first2;
+    T* end1 = first1 + (len1 < len2 ? len1 : len2);
+    while (first1 != end1) {
+        std::ptrdiff_t i = ::stl::__simd_mismatch<V>(first1, end1, first2) - first1;
+        if (i == end1 - first1)
+            break;
+        if (first1[i] < first2[i])
+            return true;
+        if (first2[i] < first1[i])
+            return false;
+        first1 += i + 1;
+        first2 += i + 1;
+    }
+    return len1 < len2;
+}
+
+template<typename T, typename U>
+inline bool __lexicographical_compare_contiguous(T* first1, T* last1, U* first2, U* last2,
+                                                 stl::__traits::__false_type,
+                                                 stl::__traits::__false_type) {
+    return ::stl::__lexicographical_compare<T*, U*>(first1, last1, first2, last2);
+}
+
+template<typename T, typename U>
+inline bool __lexicographical_compare(T* first1, T* last1, U* first2, U* last2) {
+    typedef __contiguous_compare<T, U> traits;
+    return ::stl::__lexicographical_compare_contiguous(first1, last1, first2, last2,
+                                                       typename traits::is_byte_ordered(),
+                                                       typename traits::is_vectorizable());
+}
+
+template<typename InputIterator1, typename InputIterator2>
+inline bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+                                    InputIterator2 first2, InputIterator2 last2) {
+    return ::stl::__lexicographical_compare(first1, last1, first2, last2);
+}
+
 template<typename InputIterator1, typename InputIterator2, typename Compare>
 bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
                              InputIterator2 first2, InputIterator2 last2,
@@ -112,7 +286,7 @@ min_max(const T& a, const T& b) {
 // Mismatch
 template<typename InputIterator1, typename InputIterator2>
 std::pair<InputIterator1, InputIterator2>
-mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+__mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
     while (first1 != last1 && *first1 == *first2) {
         ++first1;
         ++first2;
@@ -120,11 +294,37 @@ mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
     return std::make_pair(first1, first2);
 }
 
+template<typename T, typename U>
+inline std::pair<T*, U*>
+__mismatch_contiguous(T* first1, T* last1, U* first2, stl::__traits::__true_type) {
+    std::ptrdiff_t n = ::stl::__simd_mismatch<typename std::remove_cv<T>::type>(first1, last1, first2)
+                     - first1;
+    return std::make_pair(first1 + n, first2 + n);
+}
+
+template<typename T, typename U>
+inline std::pair<T*, U*>
+__mismatch_contiguous(T* first1, T* last1, U* first2, stl::__traits::__false_type) {
+    return ::stl::__mismatch<T*, U*>(first1, last1, first2);
+}
+
+template<typename T, typename U>
+inline std::pair<T*, U*> __mismatch(T* first1, T* last1, U* first2) {
+    return ::stl::__mismatch_contiguous(first1, last1, first2,
+                                        typename __contiguous_compare<T, U>::is_vectorizable());
+}
+
+template<typename InputIterator1, typename InputIterator2>
+inline std::pair<InputIterator1, InputIterator2>
+mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+    return ::stl::__mismatch(first1, last1, first2);
+}
+
 template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
 std::pair<InputIterator1, InputIterator2>
 mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
          BinaryPredicate binary_pred) {
-    while (first1 != last1 && binary_pred(first1, *first2)) {
+    while (first1 != last1 && binary_pred(*first1, *first2)) {
         ++first1;
         ++first2;
     }
@@ -166,7 +366,7 @@ __copy(RandomAccessIterator first, RandomAccessIterator last,
 
 template<typename T>
 inline T* __copy_t(const T* first, const T* last, T* result, stl::__traits::__true_type) {
-    std::memmove(result, first, sizeof(T) * (last - first));
+    ::stl::__copy_bytes(result, first, sizeof(T) * (last - first));
     return result + (last - first);
 }
 
@@ -200,19 +400,88 @@ struct __copy_dispatch<const T*, T*> {
 
 template<typename InputIterator, typename OutputIterator>
 inline OutputIterator copy(InputIterator first, InputIterator last,
-                           OutputIterator result) {
+                           OutputIterator result);
+
+// Copy between segmented iterators: each contiguous piece is handed back to
+// copy() as plain pointers, so it reaches the memmove path of __copy_dispatch.
+template<typename InputIterator, typename OutputIterator>
+inline OutputIterator
+__copy_segmented(InputIterator first, InputIterator last, OutputIterator result,
+                 stl::__traits::__false_type, stl::__traits::__false_type) {
     return __copy_dispatch<InputIterator, OutputIterator>()
             (first, last, result);
 }
 
+template<typename SegmentedIterator, typename OutputIterator, typename OutputSegmented>
+OutputIterator
+__copy_segmented(SegmentedIterator first, SegmentedIterator last, OutputIterator result,
+                 stl::__traits::__true_type, OutputSegmented) {
+    typedef stl::__segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast)
+        return stl::copy(traits::local(first), traits::local(last), result);
+    result = stl::copy(traits::local(first), traits::end(sfirst), result);
+    for (++sfirst; sfirst != slast; ++sfirst)
+        result = stl::copy(traits::begin(sfirst), traits::end(sfirst), result);
+    return stl::copy(traits::begin(slast), traits::local(last), result);
+}
+
+template<typename InputIterator, typename SegmentedIterator>
+inline SegmentedIterator
+__copy_to_segmented(InputIterator first, InputIterator last, SegmentedIterator result,
+                    stl::input_iterator_tag) {
+    return __copy_dispatch<InputIterator, SegmentedIterator>()
+            (first, last, result);
+}
+
+template<typename RandomAccessIterator, typename SegmentedIterator>
+SegmentedIterator
+__copy_to_segmented(RandomAccessIterator first, RandomAccessIterator last,
+                    SegmentedIterator result, stl::random_access_iterator_tag) {
+    typedef stl::__segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename stl::iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance n = last - first;
+    SegmentedIterator end = result + n;
+    typename traits::segment_iterator seg = traits::segment(result);
+    typename traits::local_iterator cur = traits::local(result);
+    while (n > 0) {
+        Distance room = traits::end(seg) - cur;
+        Distance chunk = n < room ? n : room;
+        stl::copy(first, first + chunk, cur);
+        first += chunk;
+        n -= chunk;
+        if (n > 0) {
+            ++seg;
+            cur = traits::begin(seg);
+        }
+    }
+    return end;
+}
+
+template<typename InputIterator, typename SegmentedIterator>
+inline SegmentedIterator
+__copy_segmented(InputIterator first, InputIterator last, SegmentedIterator result,
+                 stl::__traits::__false_type, stl::__traits::__true_type) {
+    return __copy_to_segmented(first, last, result, stl::iterator_category(first));
+}
+
+template<typename InputIterator, typename OutputIterator>
+inline OutputIterator copy(InputIterator first, InputIterator last,
+                           OutputIterator result) {
+    typedef typename stl::__segmented_iterator_traits<InputIterator>::is_segmented_iterator in_segmented;
+    typedef typename stl::__segmented_iterator_traits<OutputIterator>::is_segmented_iterator out_segmented;
+    return __copy_segmented(first, last, result, in_segmented(), out_segmented());
+}
+
 inline char* copy(const char* first, const char* last, char* result) {
-    std::memmove(result, first, last - first);
+    ::stl::__copy_bytes(result, first, last - first);
     return result + (last - first);
 }
 
 inline wchar_t* copy(const wchar_t* first, const wchar_t* last,
                      wchar_t* result) {
-    memmove(result, first, sizeof(wchar_t) * (last - first));
+    ::stl::__copy_bytes(result, first, sizeof(wchar_t) * (last - first));
     return result + (last - first);
 }
 
@@ -227,10 +496,49 @@ __copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
     return result;
 }
 
+template<typename T>
+inline T* __copy_backward_t(const T* first, const T* last, T* result,
+                            stl::__traits::__true_type) {
+    ::stl::__copy_bytes(result - (last - first), first, sizeof(T) * (last - first));
+    return result - (last - first);
+}
+
+template<typename T>
+inline T* __copy_backward_t(const T* first, const T* last, T* result,
+                            stl::__traits::__false_type) {
+    return __copy_backward(first, last, result,
+                           bidirectional_iterator_tag(), bidirectional_iterator_tag());
+}
+
+template<typename BidirectionalIterator1, typename BidirectionalIterator2>
+struct __copy_backward_dispatch {
+    BidirectionalIterator2 operator()(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                      BidirectionalIterator2 result) {
+        return __copy_backward(first, last, result,
+                               iterator_category(first), iterator_category(result));
+    }
+};
+
+template<typename T>
+struct __copy_backward_dispatch<T*, T*> {
+    T* operator()(T* first, T* last, T* result) {
+        typedef typename stl::__traits::__type_traits<T>::has_trivial_assignment_operator t;
+        return __copy_backward_t(first, last, result, t());
+    }
+};
+
+template<typename T>
+struct __copy_backward_dispatch<const T*, T*> {
+    T* operator()(const T* first, const T* last, T* result) {
+        typedef typename stl::__traits::__type_traits<T>::has_trivial_assignment_operator t;
+        return __copy_backward_t(first, last, result, t());
+    }
+};
+
 template<typename InputIterator, typename OutputIterator>
 inline OutputIterator copy_backward(InputIterator first, InputIterator last,
                                     OutputIterator result) {
-    return __copy_backward(first, last, result, iterator_category(first), iterator_category(result));
+    return __copy_backward_dispatch<InputIterator, OutputIterator>()(first, last, result);
 }
 
 }  // end of namespace stl
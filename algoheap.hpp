@@ -146,7 +146,7 @@ void __adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len,
         *(first + holeIndex) = *(first + (secondChild - 1));
         holeIndex = secondChild - 1;
     }
-    stl::__push_heap(first, holeIndex, topIndex, value);
+    stl::__push_heap(first, holeIndex, topIndex, value, comp);
 }
 
 template<typename RandomAccessIterator, typename T, typename Compare, typename Distance>
@@ -7,9 +7,17 @@
 #include "iterator.hpp"
 #include "utility.hpp"
 #include "numeric.hpp"
+#include "__tempbuf.hpp"
+#include "memory/alloc.hpp"
+#include "functional.hpp"
+#include "__simd.hpp"
+#include "searcher.hpp"
 
 #include <iostream>
 #include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 namespace stl
 {
@@ -39,10 +47,53 @@ ForwardIterator adjacent_find(ForwardIterator first, ForwardIterator last, Binar
      return last;
 }
 
+// Contiguous ranges
+// count, count_if, find and find_if over pointers to arithmetic types run
+// the vector kernels of __simd.hpp.  So do the predicates bind1st/bind2nd
+// make of the relational functors; any other predicate takes the loop.
+// A value of another type is converted to the element type first, which
+// is only done where no comparison result can change: between integral
+// types, after checking that the conversion is exact.
+template<typename T, typename U>
+struct __simd_value {
+    typedef typename std::remove_cv<T>::type element_type;
+    enum { value = __simd_traits<element_type>::value
+                   && (std::is_same<element_type, U>::value
+                       || (std::is_integral<element_type>::value && std::is_integral<U>::value)) };
+    typedef typename std::conditional<value, __true_type, __false_type>::type is_vectorizable;
+};
+
+template<typename Predicate, typename T>
+struct __simd_predicate {
+    enum { op = -1 };
+};
+
+template<typename T> struct __simd_predicate<binder2nd<equal_to<T>>, T> { enum { op = __simd_eq }; };
+template<typename T> struct __simd_predicate<binder2nd<not_equal_to<T>>, T> { enum { op = __simd_ne }; };
+template<typename T> struct __simd_predicate<binder2nd<less<T>>, T> { enum { op = __simd_lt }; };
+template<typename T> struct __simd_predicate<binder2nd<greater<T>>, T> { enum { op = __simd_gt }; };
+template<typename T> struct __simd_predicate<binder2nd<less_equal<T>>, T> { enum { op = __simd_le }; };
+template<typename T> struct __simd_predicate<binder2nd<greater_equal<T>>, T> { enum { op = __simd_ge }; };
+// bind1st(op, v)(x) is v op x
+template<typename T> struct __simd_predicate<binder1st<equal_to<T>>, T> { enum { op = __simd_eq }; };
+template<typename T> struct __simd_predicate<binder1st<not_equal_to<T>>, T> { enum { op = __simd_ne }; };
+template<typename T> struct __simd_predicate<binder1st<less<T>>, T> { enum { op = __simd_gt }; };
+template<typename T> struct __simd_predicate<binder1st<greater<T>>, T> { enum { op = __simd_lt }; };
+template<typename T> struct __simd_predicate<binder1st<less_equal<T>>, T> { enum { op = __simd_ge }; };
+template<typename T> struct __simd_predicate<binder1st<greater_equal<T>>, T> { enum { op = __simd_le }; };
+
+template<typename Predicate, typename T>
+struct __simd_predicate_traits {
+    typedef typename std::remove_cv<T>::type element_type;
+    enum { op = __simd_predicate<Predicate, element_type>::op };
+    typedef typename std::conditional<(op >= 0 && __simd_traits<element_type>::value),
+                                      __true_type, __false_type>::type is_vectorizable;
+};
+
 // Count
 template<typename InputIterator, typename T>
 typename stl::iterator_traits<InputIterator>::difference_type
-count(InputIterator first, InputIterator last, const T& value) {
+__count(InputIterator first, InputIterator last, const T& value) {
     typename stl::iterator_traits<InputIterator>::difference_type n = 0;
     for ( ; first != last; ++first)
         if (*first == value)
@@ -50,9 +101,37 @@ count(InputIterator first, InputIterator last, const T& value) {
     return n;
 }
 
+template<typename T, typename U>
+inline std::ptrdiff_t __count_contiguous(T* first, T* last, const U& value, __false_type) {
+    std::ptrdiff_t n = 0;
+    for ( ; first != last; ++first)
+        if (*first == value)
+            ++n;
+    return n;
+}
+
+template<typename T, typename U>
+inline std::ptrdiff_t __count_contiguous(T* first, T* last, const U& value, __true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    if (!(V(value) == value)) return 0;     // no element can compare equal
+    return stl::__simd_count_if<__simd_eq>(first, last, V(value));
+}
+
+template<typename T, typename U>
+inline std::ptrdiff_t __count(T* first, T* last, const U& value) {
+    return stl::__count_contiguous(first, last, value,
+                                   typename __simd_value<T, U>::is_vectorizable());
+}
+
+template<typename InputIterator, typename T>
+inline typename stl::iterator_traits<InputIterator>::difference_type
+count(InputIterator first, InputIterator last, const T& value) {
+    return stl::__count(first, last, value);
+}
+
 template<typename InputIterator, typename Predicate>
 typename stl::iterator_traits<InputIterator>::difference_type
-count_if(InputIterator first, InputIterator last, Predicate pred) {
+__count_if(InputIterator first, InputIterator last, Predicate pred) {
     typename stl::iterator_traits<InputIterator>::difference_type n = 0;
     for ( ; first != last; ++first)
         if (pred(*first))
@@ -60,6 +139,33 @@ count_if(InputIterator first, InputIterator last, Predicate pred) {
     return n;
 }
 
+template<typename T, typename Predicate>
+inline std::ptrdiff_t __count_if_contiguous(T* first, T* last, Predicate pred, __false_type) {
+    std::ptrdiff_t n = 0;
+    for ( ; first != last; ++first)
+        if (pred(*first))
+            ++n;
+    return n;
+}
+
+template<typename T, typename Predicate>
+inline std::ptrdiff_t __count_if_contiguous(T* first, T* last, Predicate pred, __true_type) {
+    typedef __simd_predicate_traits<Predicate, T> traits;
+    return stl::__simd_count_if<traits::op>(first, last, pred.bound_argument());
+}
+
+template<typename T, typename Predicate>
+inline std::ptrdiff_t __count_if(T* first, T* last, Predicate pred) {
+    return stl::__count_if_contiguous(first, last, pred,
+        typename __simd_predicate_traits<Predicate, T>::is_vectorizable());
+}
+
+template<typename InputIterator, typename Predicate>
+inline typename stl::iterator_traits<InputIterator>::difference_type
+count_if(InputIterator first, InputIterator last, Predicate pred) {
+    return stl::__count_if(first, last, pred);
+}
+
 // Search
 template<typename ForwardIterator1, typename ForwardIterator2,
          typename Distance1, typename Distance2>
@@ -120,11 +226,36 @@ ForwardIterator1 __search(ForwardIterator1 first1, ForwardIterator1 last1,
 }
 
 template<typename ForwardIterator1, typename ForwardIterator2>
-ForwardIterator1 search(ForwardIterator1 first1, ForwardIterator1 last1,
-                        ForwardIterator2 first2, ForwardIterator2 last2) {
+inline ForwardIterator1 __search(ForwardIterator1 first1, ForwardIterator1 last1,
+                                 ForwardIterator2 first2, ForwardIterator2 last2) {
     return __search(first1, last1, first2, last2, distance_type(first1), distance_type(first2));
 }
 
+// Byte strings take the two-way searcher: linear in the worst case, and
+// the vector filter skips the positions that cannot start a match.
+template<typename T, typename U>
+inline T* __search_contiguous(T* first1, T* last1, U* first2, U* last2, __true_type) {
+    return two_way_searcher<U*>(first2, last2)(first1, last1).first;
+}
+
+template<typename T, typename U>
+inline T* __search_contiguous(T* first1, T* last1, U* first2, U* last2, __false_type) {
+    return __search(first1, last1, first2, last2, (std::ptrdiff_t*)0, (std::ptrdiff_t*)0);
+}
+
+template<typename T, typename U>
+inline T* __search(T* first1, T* last1, U* first2, U* last2) {
+    typedef typename std::remove_cv<U>::type V;
+    return stl::__search_contiguous(first1, last1, first2, last2,
+                                    typename __searcher_bytes<U*, T*, equal_to<V> >::is_bytes());
+}
+
+template<typename ForwardIterator1, typename ForwardIterator2>
+inline ForwardIterator1 search(ForwardIterator1 first1, ForwardIterator1 last1,
+                               ForwardIterator2 first2, ForwardIterator2 last2) {
+    return stl::__search(first1, last1, first2, last2);
+}
+
 template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryOperation>
 ForwardIterator1 search(ForwardIterator1 first1, ForwardIterator1 last1,
                         ForwardIterator2 first2, ForwardIterator2 last2,
@@ -134,19 +265,90 @@ ForwardIterator1 search(ForwardIterator1 first1, ForwardIterator1 last1,
 
 // Find
 template<typename InputIterator, typename T>
-InputIterator find(InputIterator first, InputIterator last, const T& value) {
+inline InputIterator __find(InputIterator first, InputIterator last, const T& value,
+                            __false_type) {
     while (first != last && *first != value)
         ++first;
     return first;
 }
 
+template<typename SegmentedIterator, typename T>
+SegmentedIterator __find(SegmentedIterator first, SegmentedIterator last, const T& value,
+                         __true_type) {
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    typename traits::local_iterator lfirst = traits::local(first);
+    while (true) {
+        typename traits::local_iterator llast =
+            sfirst == slast ? traits::local(last) : traits::end(sfirst);
+        typename traits::local_iterator i = __find(lfirst, llast, value, __false_type());
+        if (i != llast)
+            return traits::compose(sfirst, i);
+        if (sfirst == slast)
+            return last;
+        ++sfirst;
+        lfirst = traits::begin(sfirst);
+    }
+}
+
+template<typename T, typename U>
+inline T* __find_contiguous(T* first, T* last, const U& value, __false_type) {
+    while (first != last && *first != value)
+        ++first;
+    return first;
+}
+
+template<typename T, typename U>
+inline T* __find_contiguous(T* first, T* last, const U& value, __true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    if (!(V(value) == value)) return last;
+    return first + (stl::__simd_find_if<__simd_eq>(first, last, V(value)) - first);
+}
+
+template<typename T, typename U>
+inline T* __find(T* first, T* last, const U& value, __false_type) {
+    return stl::__find_contiguous(first, last, value,
+                                  typename __simd_value<T, U>::is_vectorizable());
+}
+
+template<typename InputIterator, typename T>
+inline InputIterator find(InputIterator first, InputIterator last, const T& value) {
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+    return __find(first, last, value, segmented());
+}
+
 template<typename InputIterator, typename Predicate>
-InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
+InputIterator __find_if(InputIterator first, InputIterator last, Predicate pred) {
+    while (first != last && !pred(*first))
+        ++first;
+    return first;
+}
+
+template<typename T, typename Predicate>
+inline T* __find_if_contiguous(T* first, T* last, Predicate pred, __false_type) {
     while (first != last && !pred(*first))
         ++first;
     return first;
 }
 
+template<typename T, typename Predicate>
+inline T* __find_if_contiguous(T* first, T* last, Predicate pred, __true_type) {
+    typedef __simd_predicate_traits<Predicate, T> traits;
+    return first + (stl::__simd_find_if<traits::op>(first, last, pred.bound_argument()) - first);
+}
+
+template<typename T, typename Predicate>
+inline T* __find_if(T* first, T* last, Predicate pred) {
+    return stl::__find_if_contiguous(first, last, pred,
+        typename __simd_predicate_traits<Predicate, T>::is_vectorizable());
+}
+
+template<typename InputIterator, typename Predicate>
+inline InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
+    return stl::__find_if(first, last, pred);
+}
+
 // Search
 
 template<typename ForwardIterator, typename Integer, typename T>
@@ -243,7 +445,22 @@ ForwardIterator1
 __find_end(ForwardIterator1 first1, ForwardIterator1 last1,
            ForwardIterator2 first2, ForwardIterator2 last2,
            stl::bidirectional_iterator_tag, stl::bidirectional_iterator_tag) {
-    return search(first1, last1, first2, last2);
+    if (first2 == last2)
+        return last1;
+    // try the windows ending at last1, last1 - 1, ... until one matches or
+    // there is no room left for the pattern
+    for (ForwardIterator1 end1 = last1; ; --end1) {
+        ForwardIterator1 cur1 = end1;
+        ForwardIterator2 cur2 = last2;
+        while (true) {
+            if (cur2 == first2)
+                return cur1;
+            if (cur1 == first1)
+                return last1;
+            if (!(*--cur1 == *--cur2))
+                break;
+        }
+    }
 }
 
 template<typename InputIterator, typename ForwardIterator>
@@ -268,12 +485,41 @@ InputIterator find_first_of(InputIterator first1, InputIterator last1,
 
 // Foreach
 template<typename InputIterator, typename Function>
-Function for_each(InputIterator first, InputIterator last, Function f) {
+inline void __for_each_aux(InputIterator first, InputIterator last, Function& f) {
     for ( ; first != last; ++first)
         f(*first);
+}
+
+template<typename InputIterator, typename Function>
+inline Function __for_each(InputIterator first, InputIterator last, Function f,
+                           __false_type) {
+    __for_each_aux(first, last, f);
+    return f;
+}
+
+template<typename SegmentedIterator, typename Function>
+Function __for_each(SegmentedIterator first, SegmentedIterator last, Function f,
+                    __true_type) {
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast) {
+        __for_each_aux(traits::local(first), traits::local(last), f);
+        return f;
+    }
+    __for_each_aux(traits::local(first), traits::end(sfirst), f);
+    for (++sfirst; sfirst != slast; ++sfirst)
+        __for_each_aux(traits::begin(sfirst), traits::end(sfirst), f);
+    __for_each_aux(traits::begin(slast), traits::local(last), f);
     return f;
 }
 
+template<typename InputIterator, typename Function>
+inline Function for_each(InputIterator first, InputIterator last, Function f) {
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+    return __for_each(first, last, f, segmented());
+}
+
 // Generate
 template<typename ForwardIterator, typename Generator>
 void generate(ForwardIterator first, ForwardIterator last, Generator gen) {
@@ -321,8 +567,12 @@ bool includes(InputIterator1 first1, InputIterator1 last1,
 }
 
 // Max or min element
+// On contiguous arithmetic ranges the extreme value is found with the
+// vector min/max of __simd.hpp and its position recovered with the vector
+// find, so the result is the same element the loops pick: the first
+// minimum and maximum, and like std the last maximum for minmax_element.
 template<typename ForwardIterator>
-ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+ForwardIterator __max_element(ForwardIterator first, ForwardIterator last) {
     if (first == last) return first;
     ForwardIterator result = first;
     while (++first != last)
@@ -331,6 +581,32 @@ ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
     return result;
 }
 
+template<typename T>
+inline T* __max_element_contiguous(T* first, T* last, __false_type) {
+    return stl::__max_element<T*>(first, last);
+}
+
+template<typename T>
+inline T* __max_element_contiguous(T* first, T* last, __true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    V mn, mx;
+    if (first == last || !stl::__simd_minmax<false, true>(first, last, mn, mx))
+        return stl::__max_element<T*>(first, last);
+    return first + (stl::__simd_find_if<__simd_eq>(first, last, mx) - first);
+}
+
+template<typename T>
+inline T* __max_element(T* first, T* last) {
+    typedef typename std::remove_cv<T>::type V;
+    return stl::__max_element_contiguous(first, last,
+                                         typename __simd_traits<V>::is_vectorizable());
+}
+
+template<typename ForwardIterator>
+inline ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+    return stl::__max_element(first, last);
+}
+
 template<typename ForwardIterator, typename Compare>
 ForwardIterator max_element(ForwardIterator first, ForwardIterator last, Compare comp) {
     if (first == last) return first;
@@ -342,7 +618,7 @@ ForwardIterator max_element(ForwardIterator first, ForwardIterator last, Compare
 }
 
 template<typename ForwardIterator>
-ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+ForwardIterator __min_element(ForwardIterator first, ForwardIterator last) {
     if (first == last) return first;
     ForwardIterator result = first;
     while (++first != last)
@@ -351,37 +627,92 @@ ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
     return result;
 }
 
+template<typename T>
+inline T* __min_element_contiguous(T* first, T* last, __false_type) {
+    return stl::__min_element<T*>(first, last);
+}
+
+template<typename T>
+inline T* __min_element_contiguous(T* first, T* last, __true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    V mn, mx;
+    if (first == last || !stl::__simd_minmax<true, false>(first, last, mn, mx))
+        return stl::__min_element<T*>(first, last);
+    return first + (stl::__simd_find_if<__simd_eq>(first, last, mn) - first);
+}
+
+template<typename T>
+inline T* __min_element(T* first, T* last) {
+    typedef typename std::remove_cv<T>::type V;
+    return stl::__min_element_contiguous(first, last,
+                                         typename __simd_traits<V>::is_vectorizable());
+}
+
+template<typename ForwardIterator>
+inline ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+    return stl::__min_element(first, last);
+}
+
 template<typename ForwardIterator, typename Compare>
 ForwardIterator min_element(ForwardIterator first, ForwardIterator last, Compare comp) {
     if (first == last) return first;
     ForwardIterator result = first;
     while (++first != last)
-        if (comp(*result, *first))
+        if (comp(*first, *result))
             result = first;
     return result;
 }
 
 template<typename ForwardIterator>
-stl::pair<ForwardIterator, ForwardIterator> minmax_element(ForwardIterator first, ForwardIterator last) {
+stl::pair<ForwardIterator, ForwardIterator>
+__minmax_element(ForwardIterator first, ForwardIterator last) {
     if (first == last) return { first, first };
     stl::pair<ForwardIterator, ForwardIterator> result (first, first);
     while (++first != last) {
         if (*result.first > *first)
             result.first = first;
-        if (*result.second < *first)
+        if (!(*first < *result.second))
             result.second = first;
     }
     return result;
 }
 
+template<typename T>
+inline stl::pair<T*, T*> __minmax_element_contiguous(T* first, T* last, __false_type) {
+    return stl::__minmax_element<T*>(first, last);
+}
+
+template<typename T>
+inline stl::pair<T*, T*> __minmax_element_contiguous(T* first, T* last, __true_type) {
+    typedef typename std::remove_cv<T>::type V;
+    V mn, mx;
+    if (first == last || !stl::__simd_minmax<true, true>(first, last, mn, mx))
+        return stl::__minmax_element<T*>(first, last);
+    return stl::pair<T*, T*>(first + (stl::__simd_find_if<__simd_eq>(first, last, mn) - first),
+                             first + (stl::__simd_find_last_if<__simd_eq>(first, last, mx) - first));
+}
+
+template<typename T>
+inline stl::pair<T*, T*> __minmax_element(T* first, T* last) {
+    typedef typename std::remove_cv<T>::type V;
+    return stl::__minmax_element_contiguous(first, last,
+                                            typename __simd_traits<V>::is_vectorizable());
+}
+
+template<typename ForwardIterator>
+inline stl::pair<ForwardIterator, ForwardIterator>
+minmax_element(ForwardIterator first, ForwardIterator last) {
+    return stl::__minmax_element(first, last);
+}
+
 template<typename ForwardIterator, typename Compare>
 stl::pair<ForwardIterator, ForwardIterator> minmax_element(ForwardIterator first, ForwardIterator last, Compare comp) {
     if (first == last) return { first, first };
-    stl::pair<ForwardIterator, ForwardIterator> result = (first, first);
+    stl::pair<ForwardIterator, ForwardIterator> result(first, first);
     while (++first != last) {
-        if (comp(*result.first, *first))
+        if (comp(*first, *result.first))
             result.first = first;
-        if (comp(*first, *result.second))
+        if (!comp(*first, *result.second))
             result.second = first;
     }
     return result;
@@ -403,7 +734,7 @@ OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
         }
         ++result;
     }
-    return copy(first2, last2, copy(first1, last1, result));
+    return stl::copy(first2, last2, stl::copy(first1, last1, result));
 }
 
 template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
@@ -422,7 +753,7 @@ OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
         }
         ++result;
     }
-    return copy(first2, last2, copy(first1, last1, result));
+    return stl::copy(first2, last2, stl::copy(first1, last1, result));
 }
 
 // Partition
@@ -600,7 +931,7 @@ void __rotate_cycle(RandomAccessIterator first, RandomAccessIterator last,
 template<typename RandomAccessIterator, typename Distance>
 void __rotate(RandomAccessIterator first, RandomAccessIterator middle,
               RandomAccessIterator last, Distance*, random_access_iterator_tag) {
-    Distance n = ::stl::gcd(last - first, middle - first);
+    Distance n = stl::gcd(last - first, middle - first);
     while (n--) {
         __rotate_cycle(first, last, first + n, middle - first, value_type(first));
     }
@@ -615,7 +946,7 @@ inline void rotate(ForwardIterator first, ForwardIterator middle, ForwardIterato
 template<typename ForwardIterator, typename OutputIterator>
 OutputIterator rotate_copy(ForwardIterator first, ForwardIterator middle,
                            ForwardIterator last, OutputIterator result) {
-    return ::stl::copy(first, middle, ::stl::copy(middle, last, result));
+    return stl::copy(first, middle, stl::copy(middle, last, result));
 }
 
 // Swap Ranges
@@ -691,6 +1022,19 @@ ForwardIterator unique(ForwardIterator first, ForwardIterator last) {
 }
 
 // Lower bound
+// The random-access versions are branchless: the range is halved a fixed
+// number of times with a conditional move instead of a jump the predictor
+// can only guess, and both places the next probe could land are
+// prefetched so the cache misses of large ranges overlap.
+template<typename T>
+inline void __prefetch(const T& x) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&x);
+#else
+    (void)x;
+#endif
+}
+
 template<typename ForwardIterator, typename T, typename Distance>
 ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last,
                               const T& value, Distance*, forward_iterator_tag) {
@@ -717,20 +1061,15 @@ template<typename RandomAccessIterator, typename T, typename Distance>
 RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessIterator last,
                                    const T& value, Distance*, random_access_iterator_tag) {
     Distance len = last - first;
-    Distance half;
-    RandomAccessIterator middle;
-
-    while (len > 0) {
-        half = len >> 1;
-        middle = first + half;
-        if (*middle < value) {
-            first = middle + 1;
-            len = len - half - 1;
-        }
-        else
-            len = half;
+    if (len == 0) return first;
+    while (len > 1) {
+        Distance half = len >> 1;
+        len -= half;
+        stl::__prefetch(*(first + (len >> 1)));
+        stl::__prefetch(*(first + half + (len >> 1)));
+        first += (*(first + half) < value) ? half : 0;
     }
-    return first;
+    return first + (*first < value);
 }
 
 template<typename ForwardIterator, typename T, typename Compare, typename Distance>
@@ -761,33 +1100,29 @@ RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessItera
                                    const T& value, Compare comp, Distance*,
                                    random_access_iterator_tag) {
     Distance len = last - first;
-    Distance half;
-    RandomAccessIterator middle;
-
-    while (len > 0) {
-        half = len >> 1;
-        middle = first + half;
-        if (comp(*middle, value)) {
-            first = middle + 1;
-            len = len - half - 1;
-        }
-        else
-            len = half;
+    if (len == 0) return first;
+    while (len > 1) {
+        Distance half = len >> 1;
+        len -= half;
+        stl::__prefetch(*(first + (len >> 1)));
+        stl::__prefetch(*(first + half + (len >> 1)));
+        first += comp(*(first + half), value) ? half : 0;
     }
-    return first;
+    return first + comp(*first, value);
 }
 
 template<typename ForwardIterator, typename T>
 inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
                                    const T& value) {
-    return __lower_bound(first, last, value, distance_type(first), iterator_category(first));
+    return stl::__lower_bound(first, last, value, distance_type(first),
+                              iterator_category(first));
 }
 
 template<typename ForwardIterator, typename T, typename Compare>
 inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
-                                   Compare comp, const T& value) {
-    return __lower_bound(first, last, value, comp, 
-                         distance_type(first), iterator_category(first));
+                                   const T& value, Compare comp) {
+    return stl::__lower_bound(first, last, value, comp,
+                              distance_type(first), iterator_category(first));
 }
 
 // Upper bound
@@ -817,20 +1152,15 @@ template<typename RandomAccessIterator, typename T, typename Distance>
 RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessIterator last,
                                    const T& value, Distance*, random_access_iterator_tag) {
     Distance len = last - first;
-    Distance half;
-    RandomAccessIterator middle;
-
-    while (len > 0) {
-        half = len >> 1;
-        middle = first + half;
-        if (value < *middle)
-            len = half;
-        else  {
-            first = middle + 1;
-            len = len - half - 1;
-        }
+    if (len == 0) return first;
+    while (len > 1) {
+        Distance half = len >> 1;
+        len -= half;
+        stl::__prefetch(*(first + (len >> 1)));
+        stl::__prefetch(*(first + half + (len >> 1)));
+        first += (value < *(first + half)) ? 0 : half;
     }
-    return first;
+    return first + !(value < *first);
 }
 
 template<typename ForwardIterator, typename T, typename Compare, typename Distance>
@@ -861,45 +1191,107 @@ RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessItera
                                    const T& value, Compare comp, Distance*,
                                    random_access_iterator_tag) {
     Distance len = last - first;
+    if (len == 0) return first;
+    while (len > 1) {
+        Distance half = len >> 1;
+        len -= half;
+        stl::__prefetch(*(first + (len >> 1)));
+        stl::__prefetch(*(first + half + (len >> 1)));
+        first += comp(value, *(first + half)) ? 0 : half;
+    }
+    return first + !comp(value, *first);
+}
+
+template<typename ForwardIterator, typename T>
+inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                   const T& value) {
+    return stl::__upper_bound(first, last, value, distance_type(first),
+                              iterator_category(first));
+}
+
+template<typename ForwardIterator, typename T, typename Compare>
+inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                   const T& value, Compare comp) {
+    return stl::__upper_bound(first, last, value, comp,
+                              distance_type(first), iterator_category(first));
+}
+
+// Equal range
+// For forward iterators both bounds follow the same path until a probe hits
+// an element equal to value, then lower_bound finishes in the left part and
+// upper_bound in the right part.  For random-access iterators the branchless
+// lower_bound does the one descent and the end of the equal run is found by
+// galloping from there, which costs only the log of the run length.
+template<typename ForwardIterator, typename T, typename Compare, typename Distance>
+pair<ForwardIterator, ForwardIterator>
+__equal_range(ForwardIterator first, ForwardIterator last, const T& value,
+              Compare comp, Distance*, forward_iterator_tag) {
+    Distance len = stl::distance(first, last);
     Distance half;
-    RandomAccessIterator middle;
+    ForwardIterator middle, left, right;
 
     while (len > 0) {
         half = len >> 1;
-        middle = first + half;
-        if (comp(value, *middle))
-            len = half;
-        else  {
-            first = middle + 1;
+        middle = first;
+        stl::advance(middle, half);
+        if (comp(*middle, value)) {
+            first = middle;
+            ++first;
             len = len - half - 1;
         }
+        else if (comp(value, *middle))
+            len = half;
+        else {
+            left = stl::lower_bound(first, middle, value, comp);
+            stl::advance(first, len);
+            right = stl::upper_bound(++middle, first, value, comp);
+            return pair<ForwardIterator, ForwardIterator>(left, right);
+        }
     }
-    return first;
+    return pair<ForwardIterator, ForwardIterator>(first, first);
 }
 
-template<typename ForwardIterator, typename T>
-inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
-                                   const T& value) {
-    return __upper_bound(first, last, value, distance(first), iterator_category(first));
+template<typename RandomAccessIterator, typename T, typename Compare, typename Distance>
+pair<RandomAccessIterator, RandomAccessIterator>
+__equal_range(RandomAccessIterator first, RandomAccessIterator last, const T& value,
+              Compare comp, Distance*, random_access_iterator_tag) {
+    RandomAccessIterator left = stl::lower_bound(first, last, value, comp);
+    if (left == last || comp(value, *left))
+        return pair<RandomAccessIterator, RandomAccessIterator>(left, left);
+    Distance len = last - left;
+    Distance step = 1;
+    while (step < len && !comp(value, *(left + step)))
+        step <<= 1;
+    RandomAccessIterator right =
+        stl::upper_bound(left + (step >> 1) + 1, step < len ? left + step : last, value, comp);
+    return pair<RandomAccessIterator, RandomAccessIterator>(left, right);
 }
 
 template<typename ForwardIterator, typename T, typename Compare>
-inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
-                                   const T& value, Compare comp) {
-    return __upper_bound(first, last, value, comp, distance(first), iterator_category(first));
+inline pair<ForwardIterator, ForwardIterator>
+equal_range(ForwardIterator first, ForwardIterator last, const T& value, Compare comp) {
+    return stl::__equal_range(first, last, value, comp, distance_type(first),
+                              iterator_category(first));
+}
+
+template<typename ForwardIterator, typename T>
+inline pair<ForwardIterator, ForwardIterator>
+equal_range(ForwardIterator first, ForwardIterator last, const T& value) {
+    return stl::__equal_range(first, last, value, less<T>(), distance_type(first),
+                              iterator_category(first));
 }
 
 // Binary search
 template<typename ForwardIterator, typename T>
 bool binary_search(ForwardIterator first, ForwardIterator last, const T& value) {
-    ForwardIterator i = lower_bound(first, last, value);
+    ForwardIterator i = stl::lower_bound(first, last, value);
     return i != last && !(value < *i);
 }
 
 template<typename ForwardIterator, typename T, typename Compare>
 bool binary_search(ForwardIterator first, ForwardIterator last,
                    const T& value, Compare comp) {
-    ForwardIterator i = lower_bound(first, last, value, comp);
+    ForwardIterator i = stl::lower_bound(first, last, value, comp);
     return i != last && !comp(value, *i);
 }
 
@@ -1022,7 +1414,7 @@ void __random_shuffle(RandomAccessIterator first, RandomAccessIterator last,
                       Distance*) {
     if (first == last) return ;
     for (RandomAccessIterator i = first + 1; i != last; ++i)
-        iter_swap(i, first + Distance(::stl::rand() % ((i - first) + 1)));
+        iter_swap(i, first + Distance(stl::rand() % ((i - first) + 1)));
 }
 
 template<typename RandomAccessIterator>
@@ -1039,97 +1431,239 @@ void random_shuffle(RandomAccessIterator first, RandomAccessIterator last,
 }
 
 // Partial sort
-template<typename RandomAccessIterator, typename T>
+template<typename RandomAccessIterator, typename T, typename Compare>
 void __partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
-                    RandomAccessIterator last, T*) {
-    make_heap(first, middle);
+                    RandomAccessIterator last, T*, Compare comp) {
+    stl::make_heap(first, middle, comp);
     for (RandomAccessIterator i = middle; i < last; ++i)
-        __pop_heap(first, middle, i, T(*i), distance_type(first));
-    sort_heap(first, middle);
+        if (comp(*i, *first))
+            stl::__pop_heap(first, middle, i, T(*i), comp, distance_type(first));
+    stl::sort_heap(first, middle, comp);
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
+                         RandomAccessIterator last, Compare comp) {
+    stl::__partial_sort(first, middle, last, value_type(first), comp);
 }
 
 template<typename RandomAccessIterator>
 inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
                          RandomAccessIterator last) {
-    __partial_sort(first, middle, last, value_type(first));
-}
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::partial_sort(first, middle, last, less<T>());
+}
+
+// Partial sort copy
+// The first min(result_last - result_first, last - first) elements in comp
+// order are copied to [result_first, result_last) in sorted order.  Only one pass over the
+// input is made, so any input iterator will do.
+template<typename InputIterator, typename RandomAccessIterator, typename Compare,
+         typename Distance, typename T>
+RandomAccessIterator __partial_sort_copy(InputIterator first, InputIterator last,
+                                         RandomAccessIterator result_first,
+                                         RandomAccessIterator result_last,
+                                         Compare comp, Distance*, T*) {
+    if (result_first == result_last) return result_last;
+    RandomAccessIterator result_real_last = result_first;
+    for ( ; first != last && result_real_last != result_last; ++first, ++result_real_last)
+        *result_real_last = *first;
+    stl::make_heap(result_first, result_real_last, comp);
+    for ( ; first != last; ++first)
+        if (comp(*first, *result_first))
+            stl::__adjust_heap(result_first, Distance(0),
+                               Distance(result_real_last - result_first), T(*first), comp);
+    stl::sort_heap(result_first, result_real_last, comp);
+    return result_real_last;
+}
+
+template<typename InputIterator, typename RandomAccessIterator, typename Compare>
+inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                              RandomAccessIterator result_first,
+                                              RandomAccessIterator result_last, Compare comp) {
+    return stl::__partial_sort_copy(first, last, result_first, result_last, comp,
+                                    distance_type(result_first), value_type(result_first));
+}
+
+template<typename InputIterator, typename RandomAccessIterator>
+inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                              RandomAccessIterator result_first,
+                                              RandomAccessIterator result_last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    return stl::partial_sort_copy(first, last, result_first, result_last, less<T>());
+}
+
+// Top k
+// Streams [first, last) once through a heap of at most k elements and
+// writes the k first elements in comp order to result, sorted.  Unlike
+// partial_sort_copy the caller needs no random-access storage of its own,
+// and memory use is bounded by the elements kept however long the input
+// is: the heap grows geometrically up to k.
+template<typename T, typename Compare>
+class __bounded_heap {
+private:
+    typedef memory::simple_alloc<T, memory::alloc> data_allocator;
+
+    T* buf;
+    std::ptrdiff_t cap;
+    std::ptrdiff_t len;
+    std::ptrdiff_t limit;
+    Compare comp;
+
+    void grow() {
+        std::ptrdiff_t new_cap = cap ? (cap < limit / 2 ? 2 * cap : limit)
+                                     : (limit < 16 ? limit : 16);
+        T* new_buf = data_allocator::allocate(new_cap);
+        try {
+            memory::uninitialized_copy(buf, buf + len, new_buf);
+        }
+        catch (...) {
+            data_allocator::deallocate(new_buf, new_cap);
+            throw;
+        }
+        memory::destroy(buf, buf + len);
+        if (buf)
+            data_allocator::deallocate(buf, cap);
+        buf = new_buf;
+        cap = new_cap;
+    }
 
-template<typename RandomAccessIterator, typename T, typename Compare>
-void __partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
-                    RandomAccessIterator last, T*, Compare comp) {
-    ::stl::make_heap(first, middle, comp);
-    for (RandomAccessIterator i = middle; i < last; ++i)
-        __pop_heap(first, middle, i, T(*i), comp, distance_type(first));
-    ::stl::sort_heap(first, middle, comp);
+public:
+    __bounded_heap(std::ptrdiff_t k, Compare c)
+     : buf(0), cap(0), len(0), limit(k), comp(c) { }
+    ~__bounded_heap() {
+        memory::destroy(buf, buf + len);
+        if (buf)
+            data_allocator::deallocate(buf, cap);
+    }
+
+    __bounded_heap(const __bounded_heap&) = delete;
+    __bounded_heap& operator=(const __bounded_heap&) = delete;
+
+    void push(const T& x) {
+        if (len < limit) {
+            if (len == cap)
+                grow();
+            memory::construct(buf + len, x);
+            ++len;
+            stl::push_heap(buf, buf + len, comp);
+        }
+        else if (comp(x, *buf)) {
+            stl::__adjust_heap(buf, std::ptrdiff_t(0), len, T(x), comp);
+        }
+    }
+    void sort() { stl::sort_heap(buf, buf + len, comp); }
+
+    T* begin() { return buf; }
+    T* end() { return buf + len; }
+    std::ptrdiff_t capacity() const { return cap; }
+};
+
+template<typename InputIterator, typename Size, typename OutputIterator, typename Compare>
+OutputIterator top_k(InputIterator first, InputIterator last, Size k,
+                     OutputIterator result, Compare comp) {
+    typedef typename iterator_traits<InputIterator>::value_type T;
+    if (k <= 0) return result;
+    __bounded_heap<T, Compare> heap(std::ptrdiff_t(k), comp);
+    for ( ; first != last; ++first)
+        heap.push(*first);
+    heap.sort();
+    return stl::copy(heap.begin(), heap.end(), result);
 }
 
-template<typename RandomAccessIterator, typename Compare>
-inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
-                         RandomAccessIterator last, Compare comp) {
-    __partial_sort(first, middle, last, value_type(first), comp);
+template<typename InputIterator, typename Size, typename OutputIterator>
+inline OutputIterator top_k(InputIterator first, InputIterator last, Size k,
+                            OutputIterator result) {
+    typedef typename iterator_traits<InputIterator>::value_type T;
+    return stl::top_k(first, last, k, result, less<T>());
 }
 
 // Sort
-// TODO Enhance sort function
-template<typename RandomAccessIterator, typename T>
-void __unguarded_linear_insert(RandomAccessIterator last, T value) {
+// The operator< forms of the sort helpers forward to the Compare forms with
+// less<T>.  Comparators are taken by value, so a stateless one costs nothing
+// and its call inlines like the plain comparison.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __unguarded_linear_insert(RandomAccessIterator last, T value, Compare comp) {
     RandomAccessIterator next = last;
     --next;
-    while (value < *next) {
-        *last = *next;
+    while (comp(value, *next)) {
+        *last = std::move(*next);
         last = next;
         --next;
     }
-    *last = value;
+    *last = std::move(value);
 }
 
 template<typename RandomAccessIterator, typename T>
-inline void __linear_insert(RandomAccessIterator first, RandomAccessIterator last, T*) {
-    T value = *last;
-    if (value < *first) {
-        copy_backward(first, last, last + 1);
-        *first = value;
+inline void __unguarded_linear_insert(RandomAccessIterator last, T value) {
+    stl::__unguarded_linear_insert(last, std::move(value), less<T>());
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+inline void __linear_insert(RandomAccessIterator first, RandomAccessIterator last, T*,
+                            Compare comp) {
+    T value = std::move(*last);
+    if (comp(value, *first)) {
+        stl::copy_backward(first, last, last + 1);
+        *first = std::move(value);
     } else
-        __unguarded_linear_insert(last, value);
+        stl::__unguarded_linear_insert(last, std::move(value), comp);
 }
 
-template<typename RandomAccessIterator>
-void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
+template<typename RandomAccessIterator, typename Compare>
+void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
     if (first == last) return ;
     for (RandomAccessIterator i = first + 1; i != last; ++i)
-        __linear_insert(first, i, value_type(first));
+        stl::__linear_insert(first, i, value_type(first), comp);
 }
 
-template<typename T>
-inline const T& __median(const T& a, const T& b, const T& c) {
-    if (a < b)
-        if (b < c)
+template<typename RandomAccessIterator>
+inline void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::__insertion_sort(first, last, less<T>());
+}
+
+template<typename T, typename Compare>
+inline const T& __median(const T& a, const T& b, const T& c, Compare comp) {
+    if (comp(a, b))
+        if (comp(b, c))
             return b;
-        else if (a < c)
+        else if (comp(a, c))
             return c;
         else
             return a;
-    else if (a < c)
+    else if (comp(a, c))
         return a;
-    else if (b < c)
+    else if (comp(b, c))
         return c;
     else
         return b;
 }
 
-template<typename RandomAccessIterator, typename T>
+template<typename T>
+inline const T& __median(const T& a, const T& b, const T& c) {
+    return stl::__median(a, b, c, less<T>());
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
 RandomAccessIterator __unguarded_partition(RandomAccessIterator first,
-                                           RandomAccessIterator last, T pivot) {
+                                           RandomAccessIterator last, T pivot, Compare comp) {
     while (true) {
-        while (*first < pivot) ++first;
+        while (comp(*first, pivot)) ++first;
         --last;
-        while (pivot < *last) --last;
+        while (comp(pivot, *last)) --last;
         if (!(first < last)) return first;
-        iter_swap(first, last);
+        stl::iter_swap(first, last);
         ++first;
     }
 }
 
+template<typename RandomAccessIterator, typename T>
+inline RandomAccessIterator __unguarded_partition(RandomAccessIterator first,
+                                                  RandomAccessIterator last, T pivot) {
+    return stl::__unguarded_partition(first, last, pivot, less<T>());
+}
+
 template<typename Size>
 inline Size __lg(Size n) {
     Size k;
@@ -1139,90 +1673,1279 @@ inline Size __lg(Size n) {
 
 constexpr int __stl_threshold = 16;
 
-template<typename RandomAccessIterator, typename T, typename Size>
+template<typename RandomAccessIterator, typename T, typename Size, typename Compare>
 void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last,
-                      T*, Size depth_limit) {
+                      T*, Size depth_limit, Compare comp) {
     while(last - first > __stl_threshold) {
         if (depth_limit == 0) {
-            partial_sort(first, last, last);
+            stl::partial_sort(first, last, last, comp);
             return ;
         }
         --depth_limit;
-        RandomAccessIterator cut = 
-            __unguarded_partition(first, last,
-                                  T(__median(*first, *(first + (last - first) / 2),
-                                  *(last - 1))));
-        __introsort_loop(cut, last, value_type(first), depth_limit);
+        RandomAccessIterator cut =
+            stl::__unguarded_partition(first, last,
+                                       T(stl::__median(*first, *(first + (last - first) / 2),
+                                                       *(last - 1), comp)),
+                                       comp);
+        stl::__introsort_loop(cut, last, value_type(first), depth_limit, comp);
         last = cut;
     }
 }
 
-template<typename RandomAccessIterator, typename T>
-inline void __unguarded_insertion_sort_aux(RandomAccessIterator first,
-                                           RandomAccessIterator last, T*) {
-    for (auto i = first; i != last; ++i)
-        __unguarded_linear_insert(i, T(*i));
+template<typename RandomAccessIterator, typename T, typename Size>
+inline void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last,
+                             T*, Size depth_limit) {
+    stl::__introsort_loop(first, last, (T*)0, depth_limit, less<T>());
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                       Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    for (RandomAccessIterator i = first; i != last; ++i)
+        stl::__unguarded_linear_insert(i, T(std::move(*i)), comp);
+}
+
+template<typename RandomAccessIterator, typename Compare>
+void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    if (last - first > __stl_threshold) {
+        stl::__insertion_sort(first, first + __stl_threshold, comp);
+        stl::__unguarded_insertion_sort(first + __stl_threshold, last, comp);
+    }
+    else
+        stl::__insertion_sort(first, last, comp);
 }
 
 template<typename RandomAccessIterator>
-inline void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
-    __unguarded_insertion_sort_aux(first, last, value_type(first));
+inline void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::__final_insertion_sort(first, last, less<T>());
+}
+
+// Pattern-defeating quicksort, the engine behind sort().
+// Compared with __introsort_loop it
+//  - takes the pseudo-median of nine as pivot on large ranges,
+//  - notices when the pivot equals the element before the range (the right
+//    end of an earlier partition) and then peels off all elements equal to
+//    it in one linear pass, so many duplicates cost O(n k),
+//  - tries a bounded insertion sort when a partition needed no swaps, so
+//    sorted, reverse-sorted and nearly sorted input finishes in linear time,
+//  - swaps a few elements after a badly unbalanced partition to break up
+//    adversarial patterns, and falls back to heapsort after __lg(n) such
+//    partitions, which keeps the O(n log n) worst case of introsort.
+// Scalar keys are partitioned with the branchless block scheme of
+// BlockQuicksort (Edelkamp & Weiss): the comparisons of a block only record
+// offsets, the swaps happen afterwards.  This holds for any comparator, so
+// sorting ints with a lambda runs as fast as with less<int>.
+enum { __pdq_insertion_sort_threshold = 24 };
+enum { __pdq_ninther_threshold = 128 };
+enum { __pdq_partial_insertion_sort_limit = 8 };
+enum { __pdq_block_size = 64 };
+enum { __pdq_cacheline_size = 64 };
+
+template<typename T>
+struct __pdq_traits {
+    typedef typename __type_traits<T>::is_POD_type branchless;
+};
+
+template<typename RandomAccessIterator, typename Compare>
+void __pdq_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if (first == last) return;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// *(first - 1) must not be greater than any element of the range
+template<typename RandomAccessIterator, typename Compare>
+void __pdq_unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                    Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if (first == last) return;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up after moving __pdq_partial_insertion_sort_limit
+// elements; returns whether the range is sorted.
+template<typename RandomAccessIterator, typename Compare>
+bool __pdq_partial_insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                  Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if (first == last) return true;
+    std::size_t moved = 0;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+        }
+        if (moved > __pdq_partial_insertion_sort_limit) return false;
+    }
+    return true;
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void __pdq_sort2(RandomAccessIterator a, RandomAccessIterator b, Compare comp) {
+    if (comp(*b, *a)) stl::iter_swap(a, b);
 }
 
+template<typename RandomAccessIterator, typename Compare>
+inline void __pdq_sort3(RandomAccessIterator a, RandomAccessIterator b,
+                        RandomAccessIterator c, Compare comp) {
+    stl::__pdq_sort2(a, b, comp);
+    stl::__pdq_sort2(b, c, comp);
+    stl::__pdq_sort2(a, b, comp);
+}
+
+// Partitions [first, last) around the pivot *first: elements less than it
+// go left, the rest right.  Returns the final pivot position and whether
+// the range already was partitioned.  Needs an element not less than the
+// pivot after it, which the median selection guarantees.
+template<typename RandomAccessIterator, typename Compare>
+pair<RandomAccessIterator, bool>
+__pdq_partition_right(RandomAccessIterator first, RandomAccessIterator last,
+                      Compare comp, __false_type) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    T pivot(std::move(*first));
+    RandomAccessIterator f = first;
+    RandomAccessIterator l = last;
+
+    while (comp(*++f, pivot)) ;
+    // nothing guards the search from the right if no element was less
+    if (f - 1 == first)
+        while (f < l && !comp(*--l, pivot)) ;
+    else
+        while (!comp(*--l, pivot)) ;
+
+    bool already_partitioned = !(f < l);
+    while (f < l) {
+        stl::iter_swap(f, l);
+        while (comp(*++f, pivot)) ;
+        while (!comp(*--l, pivot)) ;
+    }
+
+    RandomAccessIterator pivot_pos = f - 1;
+    *first = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
+}
+
+// Moves the num misplaced pairs given by the offset blocks.  When both
+// blocks are the same size (reverse-sorted input) plain swaps keep the
+// order intact; otherwise a cyclic permutation saves a move per pair.
 template<typename RandomAccessIterator>
-void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
-    if (last - first > __stl_threshold) {
-        __insertion_sort(first, first + __stl_threshold);
-        __unguarded_insertion_sort(first + __stl_threshold, last);
+inline void __pdq_swap_offsets(RandomAccessIterator left, RandomAccessIterator right,
+                               unsigned char* offsets_l, unsigned char* offsets_r,
+                               std::size_t num, bool use_swaps) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if (use_swaps) {
+        for (std::size_t i = 0; i < num; ++i)
+            stl::iter_swap(left + offsets_l[i], right - offsets_r[i]);
+    } else if (num > 0) {
+        RandomAccessIterator l = left + offsets_l[0];
+        RandomAccessIterator r = right - offsets_r[0];
+        T tmp(std::move(*l));
+        *l = std::move(*r);
+        for (std::size_t i = 1; i < num; ++i) {
+            l = left + offsets_l[i];
+            *r = std::move(*l);
+            r = right - offsets_r[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(tmp);
     }
+}
+
+template<typename RandomAccessIterator, typename Compare>
+pair<RandomAccessIterator, bool>
+__pdq_partition_right(RandomAccessIterator first, RandomAccessIterator last,
+                      Compare comp, __true_type) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    T pivot(std::move(*first));
+    RandomAccessIterator f = first;
+    RandomAccessIterator l = last;
+
+    while (comp(*++f, pivot)) ;
+    if (f - 1 == first)
+        while (f < l && !comp(*--l, pivot)) ;
     else
-        __insertion_sort(first, last);
+        while (!comp(*--l, pivot)) ;
+
+    bool already_partitioned = !(f < l);
+    if (!already_partitioned) {
+        stl::iter_swap(f, l);
+        ++f;
+
+        alignas(__pdq_cacheline_size) unsigned char offsets_l[__pdq_block_size];
+        alignas(__pdq_cacheline_size) unsigned char offsets_r[__pdq_block_size];
+        RandomAccessIterator offsets_l_base = f;
+        RandomAccessIterator offsets_r_base = l;
+        std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (f < l) {
+            // refill whichever offset block ran empty; split the unknown
+            // elements between the two when both did
+            std::size_t num_unknown = l - f;
+            std::size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            std::size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            if (left_split > __pdq_block_size) left_split = __pdq_block_size;
+            for (std::size_t i = 0; i < left_split; ++i) {
+                offsets_l[num_l] = (unsigned char)i;
+                num_l += !comp(*f, pivot);
+                ++f;
+            }
+            if (right_split > __pdq_block_size) right_split = __pdq_block_size;
+            for (std::size_t i = 0; i < right_split; ) {
+                offsets_r[num_r] = (unsigned char)++i;
+                num_r += comp(*--l, pivot);
+            }
+
+            std::size_t num = num_l < num_r ? num_l : num_r;
+            stl::__pdq_swap_offsets(offsets_l_base, offsets_r_base,
+                               offsets_l + start_l, offsets_r + start_r,
+                               num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = f;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = l;
+            }
+        }
+
+        // at most one block has leftovers, move them next to the boundary
+        if (num_l) {
+            unsigned char* offsets = offsets_l + start_l;
+            while (num_l--)
+                stl::iter_swap(offsets_l_base + offsets[num_l], --l);
+            f = l;
+        }
+        if (num_r) {
+            unsigned char* offsets = offsets_r + start_r;
+            while (num_r--) {
+                stl::iter_swap(offsets_r_base - offsets[num_r], f);
+                ++f;
+            }
+            l = f;
+        }
+    }
+
+    RandomAccessIterator pivot_pos = f - 1;
+    *first = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
 }
 
+// Like __pdq_partition_right, but elements equal to the pivot go left.
+// Only used when the pivot equals *(first - 1), so nothing is less than it
+// and the left side ends up all equal.
+template<typename RandomAccessIterator, typename Compare>
+RandomAccessIterator __pdq_partition_left(RandomAccessIterator first, RandomAccessIterator last,
+                                          Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    T pivot(std::move(*first));
+    RandomAccessIterator f = first;
+    RandomAccessIterator l = last;
+
+    while (comp(pivot, *--l)) ;
+    if (l + 1 == last)
+        while (f < l && !comp(pivot, *++f)) ;
+    else
+        while (!comp(pivot, *++f)) ;
+
+    while (f < l) {
+        stl::iter_swap(f, l);
+        while (comp(pivot, *--l)) ;
+        while (!comp(pivot, *++f)) ;
+    }
+
+    RandomAccessIterator pivot_pos = l;
+    *first = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template<typename RandomAccessIterator, typename Compare, typename Branchless>
+void __pdqsort_loop(RandomAccessIterator first, RandomAccessIterator last, Compare comp,
+                    int bad_allowed, bool leftmost, Branchless branchless) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    while (true) {
+        Distance size = last - first;
+        if (size < __pdq_insertion_sort_threshold) {
+            if (leftmost)
+                stl::__pdq_insertion_sort(first, last, comp);
+            else
+                stl::__pdq_unguarded_insertion_sort(first, last, comp);
+            return;
+        }
+
+        // pivot to *first: median of three, or pseudo-median of nine
+        Distance half = size / 2;
+        if (size > __pdq_ninther_threshold) {
+            stl::__pdq_sort3(first, first + half, last - 1, comp);
+            stl::__pdq_sort3(first + 1, first + (half - 1), last - 2, comp);
+            stl::__pdq_sort3(first + 2, first + (half + 1), last - 3, comp);
+            stl::__pdq_sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            stl::iter_swap(first, first + half);
+        } else {
+            stl::__pdq_sort3(first + half, first, last - 1, comp);
+        }
+
+        // nothing in the range is less than *(first - 1); if the pivot
+        // equals it, the equal elements form a finished block
+        if (!leftmost && !comp(*(first - 1), *first)) {
+            first = stl::__pdq_partition_left(first, last, comp) + 1;
+            continue;
+        }
+
+        pair<RandomAccessIterator, bool> part =
+            stl::__pdq_partition_right(first, last, comp, branchless);
+        RandomAccessIterator pivot_pos = part.first;
+        Distance l_size = pivot_pos - first;
+        Distance r_size = last - (pivot_pos + 1);
+
+        if (l_size < size / 8 || r_size < size / 8) {
+            if (--bad_allowed == 0) {
+                stl::make_heap(first, last, comp);
+                stl::sort_heap(first, last, comp);
+                return;
+            }
+            // break up the pattern that produced the bad pivot
+            if (l_size >= __pdq_insertion_sort_threshold) {
+                stl::iter_swap(first, first + l_size / 4);
+                stl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > __pdq_ninther_threshold) {
+                    stl::iter_swap(first + 1, first + (l_size / 4 + 1));
+                    stl::iter_swap(first + 2, first + (l_size / 4 + 2));
+                    stl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    stl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= __pdq_insertion_sort_threshold) {
+                stl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                stl::iter_swap(last - 1, last - r_size / 4);
+                if (r_size > __pdq_ninther_threshold) {
+                    stl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    stl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    stl::iter_swap(last - 2, last - (1 + r_size / 4));
+                    stl::iter_swap(last - 3, last - (2 + r_size / 4));
+                }
+            }
+        } else if (part.second
+                   && stl::__pdq_partial_insertion_sort(first, pivot_pos, comp)
+                   && stl::__pdq_partial_insertion_sort(pivot_pos + 1, last, comp)) {
+            // balanced, no swaps needed and both sides nearly sorted
+            return;
+        }
+
+        stl::__pdqsort_loop(first, pivot_pos, comp, bad_allowed, leftmost, branchless);
+        first = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void __pdqsort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if (last - first > 1)
+        stl::__pdqsort_loop(first, last, comp, int(__lg(last - first)), true,
+                       typename __pdq_traits<T>::branchless());
+}
+
+// Radix sort
+// __radix_traits<T>::key maps an arithmetic value to an unsigned key of the
+// same width whose unsigned order is the order of the values: signed
+// integers get their sign bit flipped, IEEE floats get all bits flipped when
+// negative and the sign bit set otherwise.  sort_by_radix says whether
+// sort() should hand large arrays of T to radix_sort; only keys up to 32
+// bits do, wider ones gain nothing over pdqsort from the MSD passes.
+template<typename T>
+struct __radix_traits {
+    typedef __false_type sort_by_radix;
+};
+
+template<bool Narrow>
+struct __radix_sort_by_width {
+    typedef __false_type type;
+};
+
+template<>
+struct __radix_sort_by_width<true> {
+    typedef __true_type type;
+};
+
+template<typename T, typename Key, bool Signed>
+struct __radix_integer_traits {
+    typedef typename __radix_sort_by_width<(sizeof(Key) <= 4)>::type sort_by_radix;
+    typedef Key key_type;
+    static Key key(T x) {
+        return Signed ? Key(Key(x) ^ (Key(1) << (sizeof(Key) * 8 - 1))) : Key(x);
+    }
+};
+
+template<typename T, typename Key>
+struct __radix_float_traits {
+    typedef typename __radix_sort_by_width<(sizeof(Key) <= 4)>::type sort_by_radix;
+    typedef Key key_type;
+    static Key key(T x) {
+        Key bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        const Key sign = Key(1) << (sizeof(Key) * 8 - 1);
+        return (bits & sign) ? Key(~bits) : Key(bits | sign);
+    }
+};
+
+template<> struct __radix_traits<char>
+ : __radix_integer_traits<char, unsigned char, (char(-1) < 0)> { };
+template<> struct __radix_traits<signed char>
+ : __radix_integer_traits<signed char, unsigned char, true> { };
+template<> struct __radix_traits<unsigned char>
+ : __radix_integer_traits<unsigned char, unsigned char, false> { };
+template<> struct __radix_traits<short>
+ : __radix_integer_traits<short, unsigned short, true> { };
+template<> struct __radix_traits<unsigned short>
+ : __radix_integer_traits<unsigned short, unsigned short, false> { };
+template<> struct __radix_traits<int>
+ : __radix_integer_traits<int, unsigned int, true> { };
+template<> struct __radix_traits<unsigned int>
+ : __radix_integer_traits<unsigned int, unsigned int, false> { };
+template<> struct __radix_traits<long>
+ : __radix_integer_traits<long, unsigned long, true> { };
+template<> struct __radix_traits<unsigned long>
+ : __radix_integer_traits<unsigned long, unsigned long, false> { };
+template<> struct __radix_traits<long long>
+ : __radix_integer_traits<long long, unsigned long long, true> { };
+template<> struct __radix_traits<unsigned long long>
+ : __radix_integer_traits<unsigned long long, unsigned long long, false> { };
+template<> struct __radix_traits<float>
+ : __radix_float_traits<float, std::uint32_t> { };
+template<> struct __radix_traits<double>
+ : __radix_float_traits<double, std::uint64_t> { };
+
+// Radix key of an element: the key extractor's result through __radix_traits.
+template<typename T, typename KeyExtractor>
+struct __radix_key_of {
+    typedef typename std::decay<decltype(std::declval<const KeyExtractor&>()(
+        std::declval<const T&>()))>::type source_type;
+    typedef typename __radix_traits<source_type>::key_type key_type;
+
+    KeyExtractor extract;
+
+    explicit __radix_key_of(KeyExtractor e) : extract(e) { }
+    key_type operator()(const T& x) const {
+        return __radix_traits<source_type>::key(extract(x));
+    }
+};
+
+template<typename KeyOf>
+struct __radix_key_less {
+    KeyOf key_of;
+
+    explicit __radix_key_less(KeyOf k) : key_of(k) { }
+    template<typename T>
+    bool operator()(const T& x, const T& y) const { return key_of(x) < key_of(y); }
+};
+
+enum { __radix_bits = 8 };
+enum { __radix_buckets = 1 << __radix_bits };
+enum { __radix_sort_threshold = 1 << 10 };      // sort() compares below this
+enum { __radix_msd_cutoff = 64 };               // insertion sort below this
+
+// LSD: one read pass builds the histograms of every digit, then each digit
+// scatters the elements between the range and a buffer.  A digit on which
+// all keys agree is skipped.  Stable.  Returns false, leaving the range
+// untouched, if no buffer could be had.
+template<typename RandomAccessIterator, typename T, typename KeyOf>
+bool __radix_sort_lsd(RandomAccessIterator first, RandomAccessIterator last, T*, KeyOf key_of) {
+    typedef typename KeyOf::key_type Key;
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    const int digits = sizeof(Key) * 8 / __radix_bits;
+
+    Distance n = last - first;
+    __temporary_buffer<RandomAccessIterator, T> buf(first, n);
+    if (buf.size() < n)
+        return false;
+
+    Distance count[digits][__radix_buckets] = {};
+    for (RandomAccessIterator i = first; i != last; ++i) {
+        Key k = key_of(*i);
+        for (int d = 0; d < digits; ++d)
+            ++count[d][(k >> (d * __radix_bits)) & (__radix_buckets - 1)];
+    }
+
+    T* tmp = buf.begin();
+    bool in_buffer = false;
+    for (int d = 0; d < digits; ++d) {
+        Distance* bucket = count[d];
+        const int shift = d * __radix_bits;
+        Key sample = key_of(in_buffer ? *tmp : *first);
+        if (bucket[(sample >> shift) & (__radix_buckets - 1)] == n)
+            continue;
+        Distance sum = 0;
+        for (int b = 0; b < __radix_buckets; ++b) {
+            Distance c = bucket[b];
+            bucket[b] = sum;
+            sum += c;
+        }
+        if (in_buffer) {
+            for (T* i = tmp; i != tmp + n; ++i)
+                *(first + bucket[(key_of(*i) >> shift) & (__radix_buckets - 1)]++) = std::move(*i);
+        } else {
+            for (RandomAccessIterator i = first; i != last; ++i)
+                tmp[bucket[(key_of(*i) >> shift) & (__radix_buckets - 1)]++] = std::move(*i);
+        }
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer)
+        for (T* i = tmp; i != tmp + n; ++i, ++first)
+            *first = std::move(*i);
+    return true;
+}
+
+// MSD, American flag: the elements are permuted into their buckets in
+// place by following cycles, then every bucket is sorted on the next digit.
+// Needs no buffer and touches only the digits that tell keys apart, which
+// suits wide keys.  Not stable.
+template<typename RandomAccessIterator, typename T, typename KeyOf>
+void __radix_sort_msd(RandomAccessIterator first, RandomAccessIterator last, T*,
+                      KeyOf key_of, int shift) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    while (true) {
+        Distance n = last - first;
+        if (n < __radix_msd_cutoff) {
+            stl::__pdq_insertion_sort(first, last, __radix_key_less<KeyOf>(key_of));
+            return;
+        }
+
+        Distance count[__radix_buckets] = {};
+        for (RandomAccessIterator i = first; i != last; ++i)
+            ++count[(key_of(*i) >> shift) & (__radix_buckets - 1)];
+        if (count[(key_of(*first) >> shift) & (__radix_buckets - 1)] == n) {
+            if (shift == 0) return;
+            shift -= __radix_bits;
+            continue;
+        }
+
+        Distance head[__radix_buckets], tail[__radix_buckets];
+        Distance sum = 0;
+        for (int b = 0; b < __radix_buckets; ++b) {
+            head[b] = sum;
+            sum += count[b];
+            tail[b] = sum;
+        }
+        for (int b = 0; b < __radix_buckets; ++b) {
+            while (head[b] != tail[b]) {
+                T value(std::move(*(first + head[b])));
+                int d = int((key_of(value) >> shift) & (__radix_buckets - 1));
+                while (d != b) {
+                    RandomAccessIterator slot = first + head[d]++;
+                    T displaced(std::move(*slot));
+                    *slot = std::move(value);
+                    value = std::move(displaced);
+                    d = int((key_of(value) >> shift) & (__radix_buckets - 1));
+                }
+                *(first + head[b]++) = std::move(value);
+            }
+        }
+
+        if (shift == 0) return;
+        Distance lo = 0;
+        for (int b = 0; b < __radix_buckets; ++b) {
+            if (tail[b] - lo > 1)
+                stl::__radix_sort_msd(first + lo, first + tail[b], (T*)0, key_of, shift - __radix_bits);
+            lo = tail[b];
+        }
+        return;
+    }
+}
+
+template<typename RandomAccessIterator, typename T, typename KeyOf>
+void __radix_sort(RandomAccessIterator first, RandomAccessIterator last, T*, KeyOf key_of) {
+    typedef typename KeyOf::key_type Key;
+    if (last - first < __radix_msd_cutoff) {
+        stl::__pdq_insertion_sort(first, last, __radix_key_less<KeyOf>(key_of));
+        return;
+    }
+    // LSD makes a pass per digit, fine up to 32-bit keys; wider keys go MSD
+    if (sizeof(Key) <= 4 && stl::__radix_sort_lsd(first, last, (T*)0, key_of))
+        return;
+    stl::__radix_sort_msd(first, last, (T*)0, key_of, int(sizeof(Key) * 8 - __radix_bits));
+}
+
+// Sorts integer and floating point values, or records by an integer or
+// floating point key.  Keys up to 32 bits are sorted stably unless no
+// buffer could be allocated.
 template<typename RandomAccessIterator>
-inline void sort(RandomAccessIterator first, RandomAccessIterator last) {
-    if (first != last) {
-        __introsort_loop(first, last, value_type(first), __lg(last - first) * 2);
-        __final_insertion_sort(first, last);
+inline void radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::__radix_sort(first, last, (T*)0, __radix_key_of<T, identity<T>>(identity<T>()));
+}
+
+template<typename RandomAccessIterator, typename KeyExtractor>
+inline void radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyExtractor key) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::__radix_sort(first, last, (T*)0, __radix_key_of<T, KeyExtractor>(key));
+}
+
+// sort() hands large arrays of narrow radix keys to radix_sort, unless the
+// input is one ascending or descending run, which pdqsort finishes in a
+// single pass.
+template<typename RandomAccessIterator, typename T>
+void __sort(RandomAccessIterator first, RandomAccessIterator last, T*, __true_type) {
+    if (last - first < __radix_sort_threshold) {
+        stl::__pdqsort(first, last, less<T>());
+        return;
     }
+    RandomAccessIterator i = first + 1;
+    if (*i < *first)
+        while (i != last && *i < *(i - 1)) ++i;
+    else
+        while (i != last && !(*i < *(i - 1))) ++i;
+    if (i == last)
+        stl::__pdqsort(first, last, less<T>());
+    else
+        stl::__radix_sort(first, last, (T*)0, __radix_key_of<T, identity<T>>(identity<T>()));
+}
+
+template<typename RandomAccessIterator, typename T>
+inline void __sort(RandomAccessIterator first, RandomAccessIterator last, T*, __false_type) {
+    stl::__pdqsort(first, last, less<T>());
+}
+
+template<typename RandomAccessIterator>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::__sort(first, last, (T*)0, typename __radix_traits<T>::sort_by_radix());
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    stl::__pdqsort(first, last, comp);
 }
 
-// Equal range
 // Inplace merge
+// With a buffer for the shorter half, one linear merge; otherwise split
+// both halves at a binary-searched cut, rotate the middle pieces into
+// place and recurse (O(n log n) moves without any buffer).
+template<typename BidirectionalIterator1, typename BidirectionalIterator2,
+         typename BidirectionalIterator3, typename Compare>
+BidirectionalIterator3 __merge_backward(BidirectionalIterator1 first1, BidirectionalIterator1 last1,
+                                        BidirectionalIterator2 first2, BidirectionalIterator2 last2,
+                                        BidirectionalIterator3 result, Compare comp) {
+    if (first1 == last1)
+        return stl::copy_backward(first2, last2, result);
+    if (first2 == last2)
+        return stl::copy_backward(first1, last1, result);
+    --last1;
+    --last2;
+    while (true) {
+        if (comp(*last2, *last1)) {
+            *--result = *last1;
+            if (first1 == last1)
+                return stl::copy_backward(first2, ++last2, result);
+            --last1;
+        } else {
+            *--result = *last2;
+            if (first2 == last2)
+                return stl::copy_backward(first1, ++last1, result);
+            --last2;
+        }
+    }
+}
+
+// rotate through the buffer when the shorter side fits
+template<typename BidirectionalIterator1, typename BidirectionalIterator2, typename Distance>
+BidirectionalIterator1 __rotate_adaptive(BidirectionalIterator1 first, BidirectionalIterator1 middle,
+                                         BidirectionalIterator1 last, Distance len1, Distance len2,
+                                         BidirectionalIterator2 buffer, Distance buffer_size) {
+    BidirectionalIterator2 buffer_end;
+    if (len1 > len2 && len2 <= buffer_size) {
+        buffer_end = stl::copy(middle, last, buffer);
+        stl::copy_backward(first, middle, last);
+        return stl::copy(buffer, buffer_end, first);
+    } else if (len1 <= buffer_size) {
+        buffer_end = stl::copy(first, middle, buffer);
+        stl::copy(middle, last, first);
+        return stl::copy_backward(buffer, buffer_end, last);
+    } else {
+        stl::rotate(first, middle, last);
+        stl::advance(first, len2);
+        return first;
+    }
+}
+
+template<typename BidirectionalIterator, typename Distance, typename Pointer, typename Compare>
+void __merge_adaptive(BidirectionalIterator first, BidirectionalIterator middle,
+                      BidirectionalIterator last, Distance len1, Distance len2,
+                      Pointer buffer, Distance buffer_size, Compare comp) {
+    if (len1 == 0 || len2 == 0)
+        return;
+    if (len1 + len2 == 2) {
+        if (comp(*middle, *first))
+            stl::iter_swap(first, middle);
+        return;
+    }
+    if (len1 <= len2 && len1 <= buffer_size) {
+        Pointer buffer_end = stl::copy(first, middle, buffer);
+        stl::merge(buffer, buffer_end, middle, last, first, comp);
+        return;
+    }
+    if (len2 <= buffer_size) {
+        Pointer buffer_end = stl::copy(middle, last, buffer);
+        stl::__merge_backward(first, middle, buffer, buffer_end, last, comp);
+        return;
+    }
+
+    BidirectionalIterator first_cut = first;
+    BidirectionalIterator second_cut = middle;
+    Distance len11 = 0;
+    Distance len22 = 0;
+    if (len1 > len2) {
+        len11 = len1 / 2;
+        stl::advance(first_cut, len11);
+        second_cut = stl::__lower_bound(middle, last, *first_cut, comp,
+                                        distance_type(first), iterator_category(first));
+        len22 = stl::distance(middle, second_cut);
+    } else {
+        len22 = len2 / 2;
+        stl::advance(second_cut, len22);
+        first_cut = stl::__upper_bound(first, middle, *second_cut, comp,
+                                       distance_type(first), iterator_category(first));
+        len11 = stl::distance(first, first_cut);
+    }
+    BidirectionalIterator new_middle =
+        stl::__rotate_adaptive(first_cut, middle, second_cut, len1 - len11, len22,
+                          buffer, buffer_size);
+    stl::__merge_adaptive(first, first_cut, new_middle, len11, len22, buffer, buffer_size, comp);
+    stl::__merge_adaptive(new_middle, second_cut, last, len1 - len11, len2 - len22,
+                     buffer, buffer_size, comp);
+}
+
+template<typename BidirectionalIterator, typename T, typename Distance, typename Compare>
+inline void __inplace_merge_aux(BidirectionalIterator first, BidirectionalIterator middle,
+                                BidirectionalIterator last, T*, Distance*, Compare comp) {
+    Distance len1 = stl::distance(first, middle);
+    Distance len2 = stl::distance(middle, last);
+    __temporary_buffer<BidirectionalIterator, T> buf(first, len1 < len2 ? len1 : len2);
+    stl::__merge_adaptive(first, middle, last, len1, len2, buf.begin(), Distance(buf.size()), comp);
+}
+
+template<typename BidirectionalIterator, typename Compare>
+inline void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                          BidirectionalIterator last, Compare comp) {
+    if (first == middle || middle == last)
+        return;
+    stl::__inplace_merge_aux(first, middle, last, value_type(first), distance_type(first), comp);
+}
+
+template<typename BidirectionalIterator>
+inline void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                          BidirectionalIterator last) {
+    typedef typename iterator_traits<BidirectionalIterator>::value_type T;
+    stl::inplace_merge(first, middle, last, less<T>());
+}
+
+// Stable sort
+// Adaptive natural merge sort after TimSort: the input is cut into its
+// ascending runs (strictly descending ones are reversed), runs shorter than
+// a minimum length are extended by insertion sort, and the runs are merged
+// off a stack whose lengths are kept roughly Fibonacci, so merges stay
+// balanced and the stack stays short.  Before merging two runs, galloping
+// trims the prefix of the left run and the suffix of the right run that are
+// already in place; during the merge, a side that keeps winning switches to
+// galloping too.  Presorted input is handled in about n comparisons.
+enum { __timsort_min_merge = 32 };
+enum { __timsort_min_gallop = 7 };
+enum { __timsort_max_runs = 85 };   // enough for 2^64 elements
+
+// First position in [first, last) where pred turns true (pred must be
+// false...true over the range), probing 1, 3, 7, ... elements away from
+// the front, or from the back when from_back is set, then bisecting.
+template<typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator __gallop(RandomAccessIterator first, RandomAccessIterator last,
+                              Predicate pred, bool from_back) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance n = last - first;
+    if (n == 0)
+        return first;
+    Distance ofs = 1, lastofs = 0;
+    RandomAccessIterator lo, hi;
+    if (!from_back) {
+        if (pred(*first))
+            return first;
+        while (ofs < n && !pred(*(first + ofs))) {
+            lastofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > n)
+            ofs = n;
+        lo = first + (lastofs + 1);
+        hi = first + ofs;
+    } else {
+        if (!pred(*(last - 1)))
+            return last;
+        while (ofs < n && pred(*(last - (ofs + 1)))) {
+            lastofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > n)
+            ofs = n;
+        lo = last - ofs;
+        hi = last - (lastofs + 1);
+    }
+    while (lo < hi) {
+        RandomAccessIterator mid = lo + (hi - lo) / 2;
+        if (pred(*mid))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+class __timsort {
+public:
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+
+    __timsort(RandomAccessIterator first, Distance n, Compare comp)
+     : comp(comp), buf(first, (n + 1) / 2), min_gallop(__timsort_min_gallop), runs(0) { }
+
+    void sort(RandomAccessIterator first, RandomAccessIterator last);
+
+private:
+    Compare comp;
+    __temporary_buffer<RandomAccessIterator, T> buf;
+    Distance min_gallop;
+    RandomAccessIterator run_base[__timsort_max_runs];
+    Distance run_len[__timsort_max_runs];
+    int runs;
+
+    static Distance min_run_length(Distance n) {
+        Distance r = 0;
+        while (n >= __timsort_min_merge) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        return n + r;
+    }
+
+    Distance count_run(RandomAccessIterator first, RandomAccessIterator last);
+    void merge_collapse();
+    void merge_force_collapse();
+    void merge_at(int i);
+    void merge_lo(RandomAccessIterator first, Distance len1, RandomAccessIterator middle, Distance len2);
+    void merge_hi(RandomAccessIterator first, RandomAccessIterator middle, Distance len2);
+};
+
+// Length of the run at first, reversed into ascending order if it descends.
+template<typename RandomAccessIterator, typename T, typename Compare>
+typename __timsort<RandomAccessIterator, T, Compare>::Distance
+__timsort<RandomAccessIterator, T, Compare>::count_run(RandomAccessIterator first,
+                                                       RandomAccessIterator last) {
+    RandomAccessIterator run_end = first + 1;
+    if (run_end == last)
+        return 1;
+    if (comp(*run_end, *first)) {
+        // strictly descending, so reversing keeps equal elements in order
+        while (++run_end != last && comp(*run_end, *(run_end - 1))) ;
+        for (RandomAccessIterator lo = first, hi = run_end - 1; lo < hi; ++lo, --hi)
+            stl::iter_swap(lo, hi);
+    } else {
+        while (++run_end != last && !comp(*run_end, *(run_end - 1))) ;
+    }
+    return run_end - first;
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::sort(RandomAccessIterator first,
+                                                       RandomAccessIterator last) {
+    Distance remaining = last - first;
+    if (remaining < 2)
+        return;
+    Distance min_run = min_run_length(remaining);
+    while (remaining > 0) {
+        Distance len = count_run(first, last);
+        if (len < min_run) {
+            Distance forced = remaining < min_run ? remaining : min_run;
+            stl::__pdq_insertion_sort(first, first + forced, comp);
+            len = forced;
+        }
+        run_base[runs] = first;
+        run_len[runs] = len;
+        ++runs;
+        merge_collapse();
+        first += len;
+        remaining -= len;
+    }
+    merge_force_collapse();
+}
+
+// Merges until, from the top, every run is longer than the next two
+// together and than the next one.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::merge_collapse() {
+    while (runs > 1) {
+        int n = runs - 2;
+        if ((n > 0 && run_len[n - 1] <= run_len[n] + run_len[n + 1])
+            || (n > 1 && run_len[n - 2] <= run_len[n - 1] + run_len[n])) {
+            if (run_len[n - 1] < run_len[n + 1])
+                --n;
+        } else if (run_len[n] > run_len[n + 1]) {
+            break;
+        }
+        merge_at(n);
+    }
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::merge_force_collapse() {
+    while (runs > 1) {
+        int n = runs - 2;
+        if (n > 0 && run_len[n - 1] < run_len[n + 1])
+            --n;
+        merge_at(n);
+    }
+}
+
+// Merges runs i and i + 1.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::merge_at(int i) {
+    RandomAccessIterator base1 = run_base[i];
+    RandomAccessIterator base2 = run_base[i + 1];
+    Distance len1 = run_len[i];
+    Distance len2 = run_len[i + 1];
+    run_len[i] = len1 + len2;
+    if (i == runs - 3) {
+        run_base[i + 1] = run_base[i + 2];
+        run_len[i + 1] = run_len[i + 2];
+    }
+    --runs;
+
+    // elements of run 1 not greater than the head of run 2 stay put,
+    // as do the elements of run 2 not less than the tail of run 1
+    Compare c = comp;
+    RandomAccessIterator skip = stl::__gallop(base1, base2,
+                                         [&](const T& x) { return c(*base2, x); }, false);
+    len1 -= skip - base1;
+    base1 = skip;
+    if (len1 == 0)
+        return;
+    RandomAccessIterator last1 = base2 - 1;
+    len2 = stl::__gallop(base2, base2 + len2,
+                    [&](const T& x) { return !c(x, *last1); }, true) - base2;
+    if (len2 == 0)
+        return;
+
+    if (len1 <= len2 && len1 <= buf.size())
+        merge_lo(base1, len1, base2, len2);
+    else if (len2 < len1 && len2 <= buf.size())
+        merge_hi(base1, base2, len2);
+    else
+        stl::__merge_adaptive(base1, base2, base2 + len2, len1, len2,
+                         buf.begin(), Distance(buf.size()), comp);
+}
+
+// Forward merge with the left run moved to the buffer.  The right run is
+// read ahead of the write position, so it can stay in place.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::merge_lo(RandomAccessIterator first, Distance len1,
+                                                           RandomAccessIterator middle, Distance len2) {
+    T* a = buf.begin();
+    T* a_end = stl::copy(first, first + len1, a);
+    RandomAccessIterator b = middle;
+    RandomAccessIterator b_end = middle + len2;
+    RandomAccessIterator dest = first;
+    Compare c = comp;
+
+    while (true) {
+        Distance count_a = 0, count_b = 0;
+        // one element at a time while neither side keeps winning
+        do {
+            if (c(*b, *a)) {
+                *dest++ = *b++;
+                ++count_b;
+                count_a = 0;
+                if (b == b_end) goto done;
+            } else {
+                *dest++ = *a++;
+                ++count_a;
+                count_b = 0;
+                if (a == a_end) goto done;
+            }
+        } while ((count_a | count_b) < min_gallop);
+
+        // galloping: copy whole stretches found by exponential search
+        do {
+            T* a_stop = stl::__gallop(a, a_end, [&](const T& x) { return c(*b, x); }, false);
+            count_a = a_stop - a;
+            dest = stl::copy(a, a_stop, dest);
+            a = a_stop;
+            if (a == a_end) goto done;
+            *dest++ = *b++;
+            if (b == b_end) goto done;
+
+            RandomAccessIterator b_stop = stl::__gallop(b, b_end, [&](const T& x) { return !c(x, *a); }, false);
+            count_b = b_stop - b;
+            dest = stl::copy(b, b_stop, dest);
+            b = b_stop;
+            if (b == b_end) goto done;
+            *dest++ = *a++;
+            if (a == a_end) goto done;
+
+            if (min_gallop > 1) --min_gallop;
+        } while (count_a >= __timsort_min_gallop || count_b >= __timsort_min_gallop);
+        min_gallop += 2;    // penalty for leaving gallop mode
+    }
+done:
+    stl::copy(a, a_end, dest);
+}
+
+// Backward merge with the right run moved to the buffer.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __timsort<RandomAccessIterator, T, Compare>::merge_hi(RandomAccessIterator first,
+                                                           RandomAccessIterator middle, Distance len2) {
+    T* b = buf.begin();
+    T* b_end = stl::copy(middle, middle + len2, b);
+    RandomAccessIterator a = first;
+    RandomAccessIterator a_end = middle;
+    RandomAccessIterator dest = middle + len2;
+    Compare c = comp;
+
+    while (true) {
+        Distance count_a = 0, count_b = 0;
+        do {
+            if (c(*(b_end - 1), *(a_end - 1))) {
+                *--dest = *--a_end;
+                ++count_a;
+                count_b = 0;
+                if (a == a_end) goto done;
+            } else {
+                *--dest = *--b_end;
+                ++count_b;
+                count_a = 0;
+                if (b == b_end) goto done;
+            }
+        } while ((count_a | count_b) < min_gallop);
+
+        do {
+            // elements of the left run greater than the last of the right
+            RandomAccessIterator a_stop =
+                stl::__gallop(a, a_end, [&](const T& x) { return c(*(b_end - 1), x); }, true);
+            count_a = a_end - a_stop;
+            dest = stl::copy_backward(a_stop, a_end, dest);
+            a_end = a_stop;
+            if (a == a_end) goto done;
+            *--dest = *--b_end;
+            if (b == b_end) goto done;
+
+            // elements of the right run not less than the last of the left
+            T* b_stop = stl::__gallop(b, b_end, [&](const T& x) { return !c(x, *(a_end - 1)); }, true);
+            count_b = b_end - b_stop;
+            dest = stl::copy_backward(b_stop, b_end, dest);
+            b_end = b_stop;
+            if (b == b_end) goto done;
+            *--dest = *--a_end;
+            if (a == a_end) goto done;
+
+            if (min_gallop > 1) --min_gallop;
+        } while (count_a >= __timsort_min_gallop || count_b >= __timsort_min_gallop);
+        min_gallop += 2;
+    }
+done:
+    stl::copy_backward(b, b_end, dest);
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+inline void __stable_sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+    __timsort<RandomAccessIterator, T, Compare> sorter(first, last - first, comp);
+    sorter.sort(first, last);
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    if (last - first > 1)
+        stl::__stable_sort(first, last, value_type(first), comp);
+}
+
+template<typename RandomAccessIterator>
+inline void stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::stable_sort(first, last, less<T>());
+}
+
 
 // Nth element
-template<typename RandomAccessIterator, typename T>
-void __nth_element(RandomAccessIterator first, RandomAccessIterator nth,
-                   RandomAccessIterator last, T*) {
-    while (last - first > 3) {
+// Introselect: median-of-three partitioning as before, but every three
+// rounds must at least halve the range; if they do not, the rest is handed
+// to median-of-medians selection.  Either way the total work is linear.
+enum { __select_threshold = 3 };
+enum { __median_of_medians_threshold = 32 };
+
+// Three-way partition around a copy of the pivot: [first, lt) less,
+// [lt, gt) equal, [gt, last) greater.
+template<typename RandomAccessIterator, typename T, typename Compare>
+pair<RandomAccessIterator, RandomAccessIterator>
+__partition3(RandomAccessIterator first, RandomAccessIterator last, T pivot, Compare comp) {
+    RandomAccessIterator lt = first, i = first, gt = last;
+    while (i < gt) {
+        if (comp(*i, pivot))
+            stl::iter_swap(lt++, i++);
+        else if (comp(pivot, *i))
+            stl::iter_swap(i, --gt);
+        else
+            ++i;
+    }
+    return pair<RandomAccessIterator, RandomAccessIterator>(lt, gt);
+}
+
+// BFPRT: the median of the group-of-five medians is at least 3/10 of the
+// way in from either end, so each round keeps at most 7/10 of the range.
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __median_of_medians_select(RandomAccessIterator first, RandomAccessIterator nth,
+                                RandomAccessIterator last, T*, Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    while (last - first > __median_of_medians_threshold) {
+        Distance groups = (last - first) / 5;
+        for (Distance i = 0; i < groups; ++i) {
+            RandomAccessIterator group = first + 5 * i;
+            stl::__insertion_sort(group, group + 5, comp);
+            stl::iter_swap(first + i, group + 2);
+        }
+        RandomAccessIterator median = first + groups / 2;
+        stl::__median_of_medians_select(first, median, first + groups, (T*)0, comp);
+
+        pair<RandomAccessIterator, RandomAccessIterator> equal =
+            stl::__partition3(first, last, T(*median), comp);
+        if (nth < equal.first)
+            last = equal.first;
+        else if (equal.second <= nth)
+            first = equal.second;
+        else
+            return;
+    }
+    stl::__insertion_sort(first, last, comp);
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+void __introselect(RandomAccessIterator first, RandomAccessIterator nth,
+                   RandomAccessIterator last, T*, Compare comp) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance check_size = last - first;
+    int rounds = 0;
+    while (last - first > __select_threshold) {
+        if (++rounds > 3) {
+            if ((last - first) * 2 > check_size) {
+                stl::__median_of_medians_select(first, nth, last, (T*)0, comp);
+                return;
+            }
+            check_size = last - first;
+            rounds = 1;
+        }
         RandomAccessIterator cut =
-            __unguarded_partition(first, last,
-                                  T(__median(*first, *(first + (last - first) / 2),
-                                  *(last - 1))));
+            stl::__unguarded_partition(first, last,
+                                       T(stl::__median(*first, *(first + (last - first) / 2),
+                                                       *(last - 1), comp)),
+                                       comp);
         if (cut <= nth)
             first = cut;
         else
             last = cut;
     }
-    __insertion_sort(first, last);
+    stl::__insertion_sort(first, last, comp);
+}
+
+template<typename RandomAccessIterator, typename T, typename Compare>
+inline void __nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                          RandomAccessIterator last, T*, Compare comp) {
+    stl::__introselect(first, nth, last, (T*)0, comp);
+}
+
+template<typename RandomAccessIterator, typename Compare>
+inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                        RandomAccessIterator last, Compare comp) {
+    if (first == last || nth == last) return;
+    stl::__nth_element(first, nth, last, value_type(first), comp);
 }
 
 template<typename RandomAccessIterator>
 inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
                         RandomAccessIterator last) {
-    __nth_element(first, nth, last, value_type(first));
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    stl::nth_element(first, nth, last, less<T>());
 }
 
 // Merge sort
+// Top-down merge sort for bidirectional ranges, merging through one
+// temporary buffer; random access ranges go to stable_sort.
+template<typename BidirectionalIterator, typename Distance, typename Pointer, typename Compare>
+void __merge_sort_loop(BidirectionalIterator first, BidirectionalIterator last, Distance len,
+                       Pointer buffer, Distance buffer_size, Compare comp) {
+    if (len < 2)
+        return;
+    Distance half = len / 2;
+    BidirectionalIterator mid = first;
+    stl::advance(mid, half);
+    stl::__merge_sort_loop(first, mid, half, buffer, buffer_size, comp);
+    stl::__merge_sort_loop(mid, last, len - half, buffer, buffer_size, comp);
+    stl::__merge_adaptive(first, mid, last, half, len - half, buffer, buffer_size, comp);
+}
+
+template<typename BidirectionalIterator, typename T, typename Distance, typename Compare>
+inline void __merge_sort(BidirectionalIterator first, BidirectionalIterator last,
+                         T*, Distance*, Compare comp, bidirectional_iterator_tag) {
+    Distance len = stl::distance(first, last);
+    __temporary_buffer<BidirectionalIterator, T> buf(first, (len + 1) / 2);
+    stl::__merge_sort_loop(first, last, len, buf.begin(), Distance(buf.size()), comp);
+}
+
+template<typename RandomAccessIterator, typename T, typename Distance, typename Compare>
+inline void __merge_sort(RandomAccessIterator first, RandomAccessIterator last,
+                         T*, Distance*, Compare comp, random_access_iterator_tag) {
+    stl::stable_sort(first, last, comp);
+}
+
+template<typename BidirectionalIterator, typename Compare>
+inline void merge_sort(BidirectionalIterator first, BidirectionalIterator last, Compare comp) {
+    if (first != last)
+        stl::__merge_sort(first, last, value_type(first), distance_type(first), comp,
+                     iterator_category(first));
+}
+
 template<typename BidirectionalIterator>
-void merge_sort(BidirectionalIterator first, BidirectionalIterator last) {
-    typename iterator_traits<BidirectionalIterator>::difference_type n = distance(first, last);
-    if (n == 0 || n == 1)
-        return ;
-    BidirectionalIterator mid = first + n / 2;
-    merge_sort(first, mid);
-    merge_sort(mid, last);
-    inplace_merge(first, mid, last);  // TODO
+inline void merge_sort(BidirectionalIterator first, BidirectionalIterator last) {
+    typedef typename iterator_traits<BidirectionalIterator>::value_type T;
+    stl::merge_sort(first, last, less<T>());
 }
 
 }  // end of namespace stl
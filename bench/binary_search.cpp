@@ -0,0 +1,89 @@
+#include "../algorithm.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// the lower_bound() before the branchless rewrite
+static const int* branchy_lower_bound(const int* first, const int* last, int value)
+{
+    std::ptrdiff_t len = last - first;
+    while (len > 0) {
+        std::ptrdiff_t half = len >> 1;
+        const int* middle = first + half;
+        if (*middle < value) {
+            first = middle + 1;
+            len = len - half - 1;
+        }
+        else
+            len = half;
+    }
+    return first;
+}
+
+static volatile long sink;
+
+int main()
+{
+    // about L1, L2, L3 and DRAM sized arrays of int
+    const std::size_t sizes[] = {4 << 10, 64 << 10, 1 << 20, 16 << 20};
+    const std::size_t queries = 2000000;
+    std::mt19937 gen(43);
+
+    std::cout << "lower_bound on sorted int arrays, " << queries << " random queries, ns per query"
+              << std::endl
+              << "  elements    branchy  stl::lower_bound  std::lower_bound  stl::equal_range"
+              << std::endl;
+    for (auto n : sizes) {
+        std::vector<int> v(n);
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = int(2 * i);
+        std::vector<int> q(queries);
+        for (auto& x : q)
+            x = int(gen() % (2 * n));
+        const int* first = v.data();
+        const int* last = v.data() + n;
+
+        double branchy = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += branchy_lower_bound(first, last, x) - first;
+            sink = s;
+        });
+        double ours = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += stl::lower_bound(first, last, x) - first;
+            sink = s;
+        });
+        double theirs = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += std::lower_bound(first, last, x) - first;
+            sink = s;
+        });
+        double range = time_ms([&] {
+            long s = 0;
+            for (auto x : q) {
+                auto r = stl::equal_range(first, last, x);
+                s += r.second - r.first;
+            }
+            sink = s;
+        });
+        std::cout << "  " << n << "\t" << branchy * 1e6 / queries << "\t   "
+                  << ours * 1e6 / queries << "\t\t     " << theirs * 1e6 / queries << "\t\t       "
+                  << range * 1e6 / queries << std::endl;
+    }
+    return 0;
+}
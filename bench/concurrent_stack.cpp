@@ -0,0 +1,65 @@
+#include "../concurrent_stack.hpp"
+#include "../stack.hpp"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Mutex around stack<long, deque<long>>, the single-threaded adapter.
+struct locked_stack {
+    std::mutex m;
+    stl::stack<long> s;
+    void push(long x) {
+        std::lock_guard<std::mutex> lock(m);
+        s.push(x);
+    }
+    bool try_pop(long& x) {
+        std::lock_guard<std::mutex> lock(m);
+        if (s.empty())
+            return false;
+        x = s.top();
+        s.pop();
+        return true;
+    }
+};
+
+static volatile long sink;
+
+// Every thread alternates push and pop on the shared stack.
+template<typename Stack>
+static double run(Stack& st, int threads, long ops_per_thread)
+{
+    std::vector<std::thread> workers;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&st, ops_per_thread] {
+            long s = 0, x;
+            for (long i = 0; i < ops_per_thread; ++i) {
+                st.push(i);
+                if (st.try_pop(x))
+                    s += x;
+            }
+            sink = s;
+        });
+    for (auto& w : workers)
+        w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main()
+{
+    const long total = 8000000;
+    const int thread_counts[] = {1, 2, 4, 8, 16};
+
+    std::cout << "push+pop pairs, " << total << " in total, Mpairs/s" << std::endl;
+    std::cout << "  threads  concurrent_stack  mutex+stack" << std::endl;
+    for (int n : thread_counts) {
+        stl::concurrent_stack<long> cs;
+        locked_stack ls;
+        double tc = run(cs, n, total / n);
+        double tl = run(ls, n, total / n);
+        std::cout << "  " << n << "\t   " << total / tc / 1e6 << "\t\t     " << total / tl / 1e6 << std::endl;
+    }
+    return 0;
+}
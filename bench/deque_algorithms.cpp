@@ -0,0 +1,60 @@
+#include "../deque.hpp"
+#include "../vector.hpp"
+#include "../algorithm.hpp"
+#include "../numeric.hpp"
+#include <chrono>
+#include <iostream>
+
+template<typename Function>
+static double time_it(Function f, int reps = 20)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i)
+        f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / reps;
+}
+
+static volatile long sink;
+
+int main()
+{
+    const int n = 4000000;
+    stl::deque<int> ideq;
+    for (int i = 0; i < n; ++i)
+        ideq.push_back(i);
+    stl::vector<int> ivec(n, 0);
+    stl::deque<int> odeq(n, 0);
+
+    // the __false_type overloads are the element-by-element loops
+    const stl::__false_type generic = stl::__false_type();
+
+    std::cout << "deque<int> of " << n << " elements, ms per pass (segmented / generic)" << std::endl;
+    std::cout << "  copy deque->vector: "
+              << time_it([&] { stl::copy(ideq.begin(), ideq.end(), ivec.begin()); }) << " / "
+              << time_it([&] { stl::__copy_segmented(ideq.begin(), ideq.end(), ivec.begin(), generic, generic); })
+              << std::endl;
+    std::cout << "  copy deque->deque:  "
+              << time_it([&] { stl::copy(ideq.begin(), ideq.end(), odeq.begin()); }) << " / "
+              << time_it([&] { stl::__copy_segmented(ideq.begin(), ideq.end(), odeq.begin(), generic, generic); })
+              << std::endl;
+    std::cout << "  fill:               "
+              << time_it([&] { stl::fill(odeq.begin(), odeq.end(), 1); }) << " / "
+              << time_it([&] { stl::__fill(odeq.begin(), odeq.end(), 1, generic); })
+              << std::endl;
+    std::cout << "  for_each:           "
+              << time_it([&] { long s = 0; stl::for_each(ideq.begin(), ideq.end(), [&s](int x) { s += x; }); sink = s; }) << " / "
+              << time_it([&] { long s = 0; stl::__for_each(ideq.begin(), ideq.end(), [&s](int x) { s += x; }, generic); sink = s; })
+              << std::endl;
+    std::cout << "  find (miss):        "
+              << time_it([&] { sink = stl::find(ideq.begin(), ideq.end(), -1) - ideq.begin(); }) << " / "
+              << time_it([&] { sink = stl::__find(ideq.begin(), ideq.end(), -1, generic) - ideq.begin(); })
+              << std::endl;
+    std::cout << "  accumulate:         "
+              << time_it([&] { sink = stl::accumulate(ideq.begin(), ideq.end(), 0L); }) << " / "
+              << time_it([&] { sink = stl::__accumulate(ideq.begin(), ideq.end(), 0L, stl::plus<long>(), generic); })
+              << std::endl;
+    std::cout << "  accumulate vector:  "
+              << time_it([&] { sink = stl::accumulate(ivec.begin(), ivec.end(), 0L); }) << std::endl;
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../deque.hpp"
+#include "../numeric.hpp"
+#include <chrono>
+#include <iostream>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+int main()
+{
+    const std::size_t n = 4000000;
+    const std::size_t block_sizes[] = {8, 32, 128, 512, 1024, 4096, 16384};
+
+    std::cout << "deque<int>, " << n << " elements, ms per pass" << std::endl;
+    std::cout << "  block  push_back  iterate  accumulate  random[]  fifo(depth 64)" << std::endl;
+    for (auto bs : block_sizes) {
+        stl::deque<int> ideq{stl::deque_buffer_size(bs)};
+        double push = time_ms([&] {
+            for (std::size_t i = 0; i < n; ++i)
+                ideq.push_back(int(i));
+        });
+        double iterate = time_ms([&] {
+            long s = 0;
+            for (auto itr = ideq.begin(); itr != ideq.end(); ++itr)
+                s += *itr;
+            sink = s;
+        });
+        double accumulate = time_ms([&] {
+            sink = stl::accumulate(ideq.begin(), ideq.end(), 0L);
+        });
+        double random = time_ms([&] {
+            long s = 0;
+            std::size_t idx = 1;
+            for (std::size_t i = 0; i < n; ++i) {
+                idx = (idx * 1103515245 + 12345) % n;
+                s += ideq[idx];
+            }
+            sink = s;
+        });
+
+        stl::deque<int> fifo{stl::deque_buffer_size(bs)};
+        for (int i = 0; i < 64; ++i)
+            fifo.push_back(i);
+        double queue = time_ms([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                fifo.push_back(int(i));
+                fifo.pop_front();
+            }
+        });
+
+        std::cout << "  " << bs << "\t " << push << "\t    " << iterate << "\t     " << accumulate
+                  << "\t " << random << "\t   " << queue << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "../execution.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <cstring>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// GB/s of copying n bytes (counted once) with reps repetitions
+template<typename Function>
+static double gbps(std::size_t n, int reps, Function f)
+{
+    double ms = time_ms([&] {
+        for (int r = 0; r < reps; ++r)
+            f();
+    });
+    return double(n) * reps / ms / 1e6;
+}
+
+int main()
+{
+    const std::size_t threshold = stl::__simd_stream_threshold();
+    std::cout << "GB/s copying int arrays; stl::copy streams from " << (threshold >> 20)
+              << " MiB, par runs on " << stl::thread_pool::default_pool().concurrency()
+              << " threads" << std::endl
+              << "  size KiB\tmemcpy\tcached\tstream\tstl\tstl par\tbackward" << std::endl;
+    for (std::size_t bytes = 64 << 10; bytes <= (std::size_t(256) << 20); bytes *= 4) {
+        std::size_t n = bytes / sizeof(int);
+        std::vector<int> src(n, 1), dst(n, 0);
+        const int* first = src.data();
+        int* result = dst.data();
+        int reps = int((std::size_t(2) << 30) / bytes);
+        if (reps < 2)
+            reps = 2;
+
+        double memcpy_rate = gbps(bytes, reps, [&] { std::memcpy(result, first, bytes); });
+        stl::__simd_stream_threshold() = std::size_t(-1);
+        double cached = gbps(bytes, reps, [&] { stl::copy(first, first + n, result); });
+        stl::__simd_stream_threshold() = 0;
+        double stream = gbps(bytes, reps, [&] { stl::copy(first, first + n, result); });
+        stl::__simd_stream_threshold() = threshold;
+        double automatic = gbps(bytes, reps, [&] { stl::copy(first, first + n, result); });
+        double par = gbps(bytes, reps, [&] {
+            stl::copy(stl::execution::par, first, first + n, result);
+        });
+        double backward = gbps(bytes, reps, [&] {
+            stl::copy_backward(first, first + n, result + n);
+        });
+        std::cout << "  " << bytes / 1024 << "\t\t" << memcpy_rate << "\t" << cached << "\t"
+                  << stream << "\t" << automatic << "\t" << par << "\t" << backward << std::endl;
+    }
+    return 0;
+}
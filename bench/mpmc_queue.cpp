@@ -0,0 +1,109 @@
+#include "../mpmc_queue.hpp"
+#include "../queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Mutex around queue<long, deque<long>>: the baseline the worker pools use.
+struct locked_queue {
+    std::mutex m;
+    stl::queue<long> q;
+    bool try_push(long x) {
+        std::lock_guard<std::mutex> lock(m);
+        q.push(x);
+        return true;
+    }
+    bool try_pop(long& x) {
+        std::lock_guard<std::mutex> lock(m);
+        if (q.empty())
+            return false;
+        x = q.front();
+        q.pop();
+        return true;
+    }
+};
+
+template<typename Queue>
+static double run(Queue& q, int threads, long per_producer)
+{
+    std::atomic<long> remaining(threads * per_producer);
+    std::vector<std::thread> workers;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < threads; ++p)
+        workers.emplace_back([&q, per_producer] {
+            for (long i = 0; i < per_producer; ++i)
+                for (stl::__backoff wait; !q.try_push(i); wait()) { }
+        });
+    for (int c = 0; c < threads; ++c)
+        workers.emplace_back([&q, &remaining] {
+            long x;
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                if (q.try_pop(x))
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                else
+                    std::this_thread::yield();
+            }
+        });
+    for (auto& t : workers)
+        t.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template<typename Queue>
+static double run_batched(Queue& q, int threads, long per_producer)
+{
+    const long batch = 32;
+    std::atomic<long> remaining(threads * per_producer);
+    std::vector<std::thread> workers;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < threads; ++p)
+        workers.emplace_back([&q, per_producer] {
+            long in[batch];
+            for (long i = 0; i < per_producer; ) {
+                long k = 0;
+                for (; k < batch && i + k < per_producer; ++k)
+                    in[k] = i + k;
+                long pushed = q.try_push(in, in + k) - in;
+                if (pushed == 0)
+                    std::this_thread::yield();
+                i += pushed;
+            }
+        });
+    for (int c = 0; c < threads; ++c)
+        workers.emplace_back([&q, &remaining] {
+            long out[batch];
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                long k = long(q.try_pop(out, batch));
+                if (k)
+                    remaining.fetch_sub(k, std::memory_order_relaxed);
+                else
+                    std::this_thread::yield();
+            }
+        });
+    for (auto& t : workers)
+        t.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main()
+{
+    const long total = 8000000;
+    const int thread_counts[] = {1, 2, 4, 8};
+
+    std::cout << "N producers + N consumers, " << total << " longs, Mops/s" << std::endl;
+    std::cout << "  N  mpmc_queue  batched(32)  mutex+queue" << std::endl;
+    for (int n : thread_counts) {
+        long per = total / n;
+        stl::mpmc_queue<long> q1(4096), q2(4096);
+        locked_queue lq;
+        double t1 = run(q1, n, per);
+        double t2 = run_batched(q2, n, per);
+        double t3 = run(lq, n, per);
+        std::cout << "  " << n << "  " << total / t1 / 1e6 << "\t" << total / t2 / 1e6
+                  << "\t" << total / t3 / 1e6 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "../algorithm.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// the nth_element() engine before introselect: median-of-three quickselect
+// without any fallback
+template<typename RandomAccessIterator, typename Compare>
+static void quickselect(RandomAccessIterator first, RandomAccessIterator nth,
+                        RandomAccessIterator last, Compare comp)
+{
+    while (last - first > 3) {
+        RandomAccessIterator cut =
+            stl::__unguarded_partition(first, last,
+                                       int(stl::__median(*first, *(first + (last - first) / 2),
+                                                         *(last - 1), comp)),
+                                       comp);
+        if (cut <= nth)
+            first = cut;
+        else
+            last = cut;
+    }
+    stl::__insertion_sort(first, last, comp);
+}
+
+// Musser's median-of-3 killer, n even
+static void fill_killer(std::vector<int>& v)
+{
+    const int k = int(v.size()) / 2;
+    for (int i = 1; i <= k; ++i) {
+        if (i % 2) {
+            v[i - 1] = i;
+            v[i] = k + i;
+        }
+        v[k + i - 1] = 2 * i;
+    }
+}
+
+static void fill_pattern(std::vector<int>& v, int pattern, std::mt19937& gen)
+{
+    const int n = int(v.size());
+    switch (pattern) {
+    case 0: for (auto& x : v) x = int(gen()); break;
+    case 1: for (int i = 0; i < n; ++i) v[i] = i; break;
+    case 2: for (auto& x : v) x = int(gen() % 16); break;
+    case 3: fill_killer(v); break;
+    }
+}
+
+int main()
+{
+    const char* names[] = {"random", "sorted", "16 values", "m3 killer"};
+    std::mt19937 gen(41);
+    long comparisons = 0;
+    auto counting_less = [&](int a, int b) { ++comparisons; return a < b; };
+
+    for (int n : {20000, 1000000}) {
+        std::cout << "nth_element(n/2), n = " << n
+                  << ", comparisons per element / ms: stl / quickselect / std" << std::endl;
+        std::vector<int> src(n), v(n);
+        for (int p = 0; p < 4; ++p) {
+            fill_pattern(src, p, gen);
+            v = src;
+            comparisons = 0;
+            double stl_ms = time_ms([&] {
+                stl::nth_element(v.data(), v.data() + n / 2, v.data() + n, counting_less);
+            });
+            double stl_cmp = double(comparisons) / n;
+
+            // quadratic on the killer, only run it on the small input
+            double quick_ms = 0, quick_cmp = 0;
+            if (p != 3 || n <= 20000) {
+                v = src;
+                comparisons = 0;
+                quick_ms = time_ms([&] {
+                    quickselect(v.data(), v.data() + n / 2, v.data() + n, counting_less);
+                });
+                quick_cmp = double(comparisons) / n;
+            }
+
+            v = src;
+            comparisons = 0;
+            double std_ms = time_ms([&] {
+                std::nth_element(v.data(), v.data() + n / 2, v.data() + n, counting_less);
+            });
+            double std_cmp = double(comparisons) / n;
+
+            std::cout << "  " << names[p] << ":\t" << stl_cmp << " / " << stl_ms << "ms\t"
+                      << quick_cmp << " / " << quick_ms << "ms\t"
+                      << std_cmp << " / " << std_ms << "ms" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "../execution.hpp"
+#include "../vector.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+template<typename Function>
+static double time_ms(Function f, int reps = 5)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i)
+        f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / reps;
+}
+
+static volatile double sink;
+
+int main()
+{
+    const long n = 16 * 1024 * 1024;
+    stl::vector<double> a(n, 1.0), b(n, 0.0);
+    for (long i = 0; i < n; ++i)
+        a[i] = double(i % 1000);
+
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4)
+        max_threads = 4;
+
+    std::cout << n << " doubles, ms per pass (speedup over 1 thread)" << std::endl;
+    std::cout << "  threads  for_each  transform  count_if  find_if  fill  copy  reduce" << std::endl;
+    double base[7] = {};
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        stl::thread_pool pool(t - 1);
+        auto policy = stl::execution::par.on(pool);
+        double r[7];
+        r[0] = time_ms([&] {
+            stl::for_each(policy, a.begin(), a.end(), [](double& x) { x = std::sqrt(x * x + 1.0); });
+        });
+        r[1] = time_ms([&] {
+            stl::transform(policy, a.begin(), a.end(), b.begin(), [](double x) { return x * 0.5 + 1.0; });
+        });
+        r[2] = time_ms([&] {
+            sink = double(stl::count_if(policy, a.begin(), a.end(), [](double x) { return x > 500.0; }));
+        });
+        r[3] = time_ms([&] {
+            sink = double(stl::find_if(policy, a.begin(), a.end(), [](double x) { return x < 0.0; }) - a.begin());
+        });
+        r[4] = time_ms([&] { stl::fill(policy, b.begin(), b.end(), 2.0); });
+        r[5] = time_ms([&] { stl::copy(policy, a.begin(), a.end(), b.begin()); });
+        r[6] = time_ms([&] { sink = stl::reduce(policy, a.begin(), a.end(), 0.0); });
+        if (t == 1)
+            for (int i = 0; i < 7; ++i)
+                base[i] = r[i];
+        std::cout << "  " << t;
+        for (int i = 0; i < 7; ++i)
+            std::cout << "  " << r[i] << " (" << base[i] / r[i] << "x)";
+        std::cout << std::endl;
+    }
+
+    std::cout << "grain size, reduce with " << max_threads << " threads:" << std::endl;
+    stl::thread_pool pool(max_threads - 1);
+    const std::size_t grains[] = {256, 4096, 65536, 1 << 20};
+    for (std::size_t g : grains)
+        std::cout << "  grain " << g << ": "
+                  << time_ms([&] { sink = stl::reduce(stl::execution::par.on(pool).grain_size(g),
+                                                      a.begin(), a.end(), 0.0); })
+                  << " ms" << std::endl;
+    return 0;
+}
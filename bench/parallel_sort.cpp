@@ -0,0 +1,56 @@
+#include "../execution.hpp"
+#include "../vector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// usage: bench_parallel_sort [elements ...]   (default 10M; 1B needs ~4 GB)
+template<typename Function>
+static double time_s(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void fill_random(stl::vector<int>& v, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = int(gen());
+}
+
+int main(int argc, char** argv)
+{
+    stl::vector<long> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(std::atol(argv[i]));
+    if (sizes.empty())
+        sizes.push_back(10000000L);
+
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4)
+        max_threads = 4;
+
+    for (long n : sizes) {
+        stl::vector<int> v(std::size_t(n), 0);
+        std::cout << n << " random ints, seconds" << std::endl;
+
+        fill_random(v, 1);
+        std::cout << "  std::sort:          " << time_s([&] { std::sort(v.begin(), v.end()); }) << std::endl;
+        fill_random(v, 1);
+        double seq = time_s([&] { stl::sort(v.begin(), v.end()); });
+        std::cout << "  stl::sort:          " << seq << std::endl;
+
+        for (unsigned t = 1; t <= max_threads; t *= 2) {
+            stl::thread_pool pool(t - 1);
+            fill_random(v, 1);
+            double par = time_s([&] { stl::sort(stl::execution::par.on(pool), v.begin(), v.end()); });
+            std::cout << "  stl::sort(par) x" << t << ": " << par << " (" << seq / par << "x)" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "../queue.hpp"
+#include "../memory/alloc.hpp"
+#include "../ring_buffer.hpp"
+#include <queue>
+#include <chrono>
+#include <iostream>
+#include <cstddef>
+
+// Counts buffer allocations made on behalf of the deque
+struct counting_alloc {
+    static std::size_t allocations;
+    static void *allocate(std::size_t n) {
+        ++allocations;
+        return stl::alloc::allocate(n);
+    }
+    static void deallocate(void *p, std::size_t n) {
+        stl::alloc::deallocate(p, n);
+    }
+};
+std::size_t counting_alloc::allocations = 0;
+
+template<typename Queue>
+static double steady_state(Queue& q, std::size_t depth, std::size_t ops)
+{
+    for (std::size_t i = 0; i < depth; ++i)
+        q.push(int(i));
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        q.push(int(i));
+        q.pop();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main()
+{
+    const std::size_t ops = 20000000;
+    const std::size_t depths[] = {1, 64, 127, 128, 4096};
+
+    std::cout << "steady-state push+pop, " << ops << " ops" << std::endl;
+    for (auto depth : depths) {
+        stl::queue<int, stl::deque<int, counting_alloc>> sq;
+        counting_alloc::allocations = 0;
+        double ts = steady_state(sq, depth, ops);
+        std::size_t allocs = counting_alloc::allocations;
+
+        std::queue<int> q;
+        double tq = steady_state(q, depth, ops);
+
+        stl::queue<int, stl::ring_buffer<int>> rq(stl::ring_buffer<int>(depth + 1));
+        double tr = steady_state(rq, depth, ops);
+
+        std::cout << "  depth " << depth
+                  << ": stl::queue " << ops / ts / 1e6 << " Mops/s (" << allocs << " allocations)"
+                  << ", std::queue " << ops / tq / 1e6 << " Mops/s"
+                  << ", ring_buffer " << ops / tr / 1e6 << " Mops/s" << std::endl;
+    }
+    return 0;
+}
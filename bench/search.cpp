@@ -0,0 +1,99 @@
+#include "../algorithm.hpp"
+#include "../searcher.hpp"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+// occurrences of the needle, each search starting after the last match
+template<typename Search>
+static long count_all(const char* first, const char* last, std::size_t m, Search search)
+{
+    long n = 0;
+    for (const char* p = search(first, last); p != last; p = search(p + m, last))
+        ++n;
+    return n;
+}
+
+int main()
+{
+    // a synthetic log: timestamped lines of words, with a rare marker
+    std::mt19937 gen(50);
+    const char* words[] = {"INFO", "DEBUG", "request", "handled", "user", "id=", "latency",
+                           "ms", "cache", "miss", "hit", "GET", "/api/v1/items", "200",
+                           "connection", "closed", "retry"};
+    std::string text;
+    while (text.size() < (std::size_t(16) << 20)) {
+        text += "2024-05-0" + std::to_string(gen() % 9 + 1) + " 12:" + std::to_string(gen() % 60);
+        int nwords = 4 + int(gen() % 8);
+        for (int i = 0; i < nwords; ++i) {
+            text += ' ';
+            text += words[gen() % 17];
+        }
+        if (gen() % 5000 == 0)
+            text += " ERROR upstream timeout after 30000 ms";
+        text += '\n';
+    }
+    const char* first = text.data();
+    const char* last = first + text.size();
+    const double mb = double(text.size()) / 1e6;
+
+    const char* needles[] = {"ms\n", "ERROR", "connection closed", "upstream timeout after 30000 ms",
+                             "ERROR upstream timeout after 30000 ms\n2024-05-0"};
+    std::cout << "GB/s counting needles in " << text.size() / (1 << 20) << " MiB of log text"
+              << std::endl
+              << "  m   naive\tstd\tstd bmh\tbmh\tbmh vec\ttwo-way\ttwo-way vec" << std::endl;
+    for (const char* needle : needles) {
+        std::size_t m = std::char_traits<char>::length(needle);
+        const char* p = needle;
+        const char* q = needle + m;
+        long expected = count_all(first, last, m, [&](const char* a, const char* b) {
+            return std::search(a, b, p, q);
+        });
+        auto run = [&](auto search) {
+            long n = 0;
+            double ms = time_ms([&] { n = count_all(first, last, m, search); });
+            if (n != expected)
+                std::cout << "  mismatch: " << n << " != " << expected << std::endl;
+            sink = n;
+            return mb / ms;     // GB/s
+        };
+
+        double naive = run([&](const char* a, const char* b) {
+            return stl::__search(a, b, p, q, (std::ptrdiff_t*)0, (std::ptrdiff_t*)0);
+        });
+        double std_search = run([&](const char* a, const char* b) {
+            return std::search(a, b, p, q);
+        });
+        std::boyer_moore_horspool_searcher<const char*> std_bmh(p, q);
+        double std_bmh_rate = run([&](const char* a, const char* b) {
+            return std_bmh(a, b).first;
+        });
+        stl::boyer_moore_horspool_searcher<const char*> bmh(p, q);
+        stl::two_way_searcher<const char*> two_way(p, q);
+        double rates[2][2];
+        for (int vec = 0; vec < 2; ++vec) {
+            stl::__simd_max_level() = vec ? stl::__simd_avx2 : stl::__simd_scalar;
+            rates[vec][0] = run([&](const char* a, const char* b) { return bmh(a, b).first; });
+            rates[vec][1] = run([&](const char* a, const char* b) { return two_way(a, b).first; });
+        }
+        std::cout << "  " << m << "\t" << naive << "\t" << std_search << "\t" << std_bmh_rate
+                  << "\t" << rates[0][0] << "\t" << rates[1][0] << "\t" << rates[0][1] << "\t"
+                  << rates[1][1] << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "../algobase.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+// GB/s (of both ranges) of equal / mismatch / lexicographical_compare over
+// two copies differing only in the last element, at each dispatch level and
+// of the std versions
+template<typename T>
+static void compare_row(const char* name, std::size_t n, int reps, std::mt19937& gen)
+{
+    std::vector<T> a(n);
+    for (auto& x : a)
+        x = T(gen() % 100);
+    std::vector<T> b(a);
+    b[n - 1] = T(b[n - 1] + 1);
+    const T* p = a.data();
+    const T* q = b.data();
+    const double bytes = 2.0 * n * sizeof(T) * reps;
+    const char* levels[] = {"scalar", "sse2", "avx2"};
+
+    std::cout << "  " << name << std::endl;
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2 + 1; ++level) {
+        stl::__simd_max_level() = level;
+        bool std_row = level > stl::__simd_avx2;
+        double eq = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = std_row ? std::equal(p, p + n, q) : stl::equal(p, p + n, q);
+        });
+        double mm = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = std_row ? std::mismatch(p, p + n, q).first - p
+                               : stl::mismatch(p, p + n, q).first - p;
+        });
+        double lc = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = std_row ? std::lexicographical_compare(p, p + n, q, q + n)
+                               : stl::lexicographical_compare(p, p + n, q, q + n);
+        });
+        std::cout << "    " << (std_row ? "std" : levels[level]) << ":\t" << bytes / eq / 1e6
+                  << "\t" << bytes / mm / 1e6 << "\t" << bytes / lc / 1e6 << std::endl;
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
+int main()
+{
+    std::mt19937 gen(47);
+    const std::size_t sizes[] = {16 << 10, 16 << 20};
+    std::cout << "GB/s: equal / mismatch / lexicographical_compare" << std::endl;
+    for (auto bytes : sizes) {
+        int reps = int((256 << 20) / bytes);
+        std::cout << bytes / 1024 << " KiB arrays" << std::endl;
+        compare_row<unsigned char>("uint8", bytes, reps, gen);
+        compare_row<char>("char", bytes, reps, gen);
+        compare_row<int>("int32", bytes / 4, reps, gen);
+        compare_row<double>("double", bytes / 8, reps, gen);
+    }
+    return 0;
+}
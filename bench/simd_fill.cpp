@@ -0,0 +1,67 @@
+#include "../algobase.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// GB/s of fill at each dispatch level with cached stores, with streaming
+// stores, and of std::fill
+template<typename T>
+static void fill_row(const char* name, std::size_t n, int reps, T value)
+{
+    std::vector<T> v(n);
+    T* first = v.data();
+    T* last = v.data() + n;
+    const double bytes = double(n) * sizeof(T) * reps;
+    const char* levels[] = {"scalar", "sse2", "avx2"};
+    const std::size_t threshold = stl::__simd_stream_threshold();
+
+    std::cout << "  " << name << std::endl;
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        stl::__simd_stream_threshold() = std::size_t(-1);
+        double cached = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                stl::fill(first, last, value);
+        });
+        stl::__simd_stream_threshold() = 0;
+        double streamed = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                stl::fill(first, last, value);
+        });
+        std::cout << "    " << levels[level] << ":\t" << bytes / cached / 1e6 << "\t"
+                  << bytes / streamed / 1e6 << std::endl;
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+    stl::__simd_stream_threshold() = threshold;
+    double theirs = time_ms([&] {
+        for (int r = 0; r < reps; ++r)
+            std::fill(first, last, value);
+    });
+    std::cout << "    std:\t" << bytes / theirs / 1e6 << std::endl;
+}
+
+int main()
+{
+    const std::size_t sizes[] = {16 << 10, 1 << 20, 64 << 20};
+    std::cout << "GB/s: fill with cached / streaming stores (default streams from "
+              << (stl::__simd_stream_threshold() >> 20) << " MiB)" << std::endl;
+    for (auto bytes : sizes) {
+        int reps = int((1 << 30) / bytes);
+        std::cout << bytes / 1024 << " KiB arrays" << std::endl;
+        fill_row<short>("int16", bytes / 2, reps, short(0x1234));
+        fill_row<int>("int32", bytes / 4, reps, 0x01020304);
+        fill_row<double>("double", bytes / 8, reps, 3.25);
+    }
+    return 0;
+}
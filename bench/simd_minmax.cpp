@@ -0,0 +1,72 @@
+#include "../algorithm.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+// GB/s of min_element / max_element / minmax_element at each dispatch
+// level and of the std versions
+template<typename T>
+static void minmax_row(const char* name, std::size_t n, int reps, std::mt19937& gen)
+{
+    std::vector<T> v(n);
+    for (auto& x : v)
+        x = T(gen() % 1000000);
+    const T* first = v.data();
+    const T* last = v.data() + n;
+    const double bytes = double(n) * sizeof(T) * reps;
+    const char* levels[] = {"scalar", "sse2", "avx2"};
+
+    std::cout << "  " << name << std::endl;
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2 + 1; ++level) {
+        stl::__simd_max_level() = level;
+        bool std_row = level > stl::__simd_avx2;
+        double mn = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = (std_row ? std::min_element(first, last) : stl::min_element(first, last))
+                     - first;
+        });
+        double mx = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = (std_row ? std::max_element(first, last) : stl::max_element(first, last))
+                     - first;
+        });
+        double mm = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = std_row ? std::minmax_element(first, last).first - first
+                               : stl::minmax_element(first, last).first - first;
+        });
+        std::cout << "    " << (std_row ? "std" : levels[level]) << ":\t" << bytes / mn / 1e6
+                  << "\t" << bytes / mx / 1e6 << "\t" << bytes / mm / 1e6 << std::endl;
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
+int main()
+{
+    std::mt19937 gen(46);
+    const std::size_t sizes[] = {16 << 10, 16 << 20};
+    std::cout << "GB/s: min_element / max_element / minmax_element" << std::endl;
+    for (auto bytes : sizes) {
+        int reps = int((256 << 20) / bytes);
+        std::cout << bytes / 1024 << " KiB arrays" << std::endl;
+        minmax_row<unsigned char>("uint8", bytes, reps, gen);
+        minmax_row<int>("int32", bytes / 4, reps, gen);
+        minmax_row<float>("float", bytes / 4, reps, gen);
+        minmax_row<double>("double", bytes / 8, reps, gen);
+    }
+    return 0;
+}
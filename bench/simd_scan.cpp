@@ -0,0 +1,83 @@
+#include "../algorithm.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+// GB/s of count, find (no match, so a full scan) and count_if(bind2nd(less))
+// at each dispatch level, and of the std versions
+template<typename T>
+static void scan_row(const char* name, std::size_t n, int reps, std::mt19937& gen)
+{
+    std::vector<T> v(n);
+    for (auto& x : v)
+        x = T(gen() % 100);
+    const T* first = v.data();
+    const T* last = v.data() + n;
+    const double bytes = double(n) * sizeof(T) * reps;
+    const char* levels[] = {"scalar", "sse2", "avx2"};
+
+    std::cout << "  " << name << std::endl;
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        double count = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = stl::count(first, last, T(42));
+        });
+        double find = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = stl::find(first, last, T(101)) - first;
+        });
+        double count_if = time_ms([&] {
+            for (int r = 0; r < reps; ++r)
+                sink = stl::count_if(first, last, stl::bind2nd(stl::less<T>(), T(50)));
+        });
+        std::cout << "    " << levels[level] << ":\t" << bytes / count / 1e6 << "\t"
+                  << bytes / find / 1e6 << "\t" << bytes / count_if / 1e6 << std::endl;
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+
+    double count = time_ms([&] {
+        for (int r = 0; r < reps; ++r)
+            sink = std::count(first, last, T(42));
+    });
+    double find = time_ms([&] {
+        for (int r = 0; r < reps; ++r)
+            sink = std::find(first, last, T(101)) - first;
+    });
+    double count_if = time_ms([&] {
+        for (int r = 0; r < reps; ++r)
+            sink = std::count_if(first, last, [](T x) { return x < T(50); });
+    });
+    std::cout << "    std:\t" << bytes / count / 1e6 << "\t" << bytes / find / 1e6 << "\t"
+              << bytes / count_if / 1e6 << std::endl;
+}
+
+int main()
+{
+    std::mt19937 gen(45);
+    const std::size_t sizes[] = {16 << 10, 16 << 20};
+    std::cout << "GB/s: count / find / count_if(bind2nd(less))" << std::endl;
+    for (auto bytes : sizes) {
+        int reps = int((256 << 20) / bytes);
+        std::cout << bytes / 1024 << " KiB arrays" << std::endl;
+        scan_row<signed char>("int8", bytes, reps, gen);
+        scan_row<int>("int32", bytes / 4, reps, gen);
+        scan_row<float>("float", bytes / 4, reps, gen);
+        scan_row<long long>("int64", bytes / 8, reps, gen);
+    }
+    return 0;
+}
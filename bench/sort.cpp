@@ -0,0 +1,112 @@
+#include "../algorithm.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// the sort() engine before pdqsort
+template<typename RandomAccessIterator>
+static void introsort(RandomAccessIterator first, RandomAccessIterator last)
+{
+    if (first != last) {
+        stl::__introsort_loop(first, last, stl::value_type(first), stl::__lg(last - first) * 2);
+        stl::__final_insertion_sort(first, last);
+    }
+}
+
+static void fill_pattern(std::vector<int>& v, int pattern, std::mt19937& gen)
+{
+    const int n = int(v.size());
+    for (int i = 0; i < n; ++i) {
+        switch (pattern) {
+        case 0: v[i] = int(gen()); break;
+        case 1: v[i] = i; break;
+        case 2: v[i] = n - i; break;
+        case 3: v[i] = int(gen() % 16); break;
+        case 4: v[i] = i < n / 2 ? i : n - i; break;
+        case 5: v[i] = i % 4096; break;
+        case 6: v[i] = i < n - n / 100 ? i : int(gen() % n); break;
+        }
+    }
+}
+
+template<typename T>
+static void radix_row(const char* name, int n, std::mt19937& gen)
+{
+    std::vector<T> src(n), v(n);
+    std::uniform_int_distribution<long long> dist(-(1LL << 40), 1LL << 40);
+    for (int i = 0; i < n; ++i)
+        src[i] = std::is_floating_point<T>::value ? T(dist(gen)) / T(1 << 20)
+                                                  : T(std::uint64_t(gen()) << 32 | gen());
+    v = src;
+    double radix_ms = time_ms([&] { stl::radix_sort(v.data(), v.data() + n); });
+    v = src;
+    double pdq_ms = time_ms([&] { stl::__pdqsort(v.data(), v.data() + n, stl::less<T>()); });
+    v = src;
+    double std_ms = time_ms([&] { std::sort(v.data(), v.data() + n); });
+    std::cout << "  " << name << ":\t" << radix_ms << " / " << pdq_ms << " / " << std_ms << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const int n = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    const char* names[] = {"random", "sorted", "reversed", "16 unique", "organ pipe",
+                           "sawtooth", "sorted+1% tail"};
+
+    std::cout << "sort " << n << " ints, ms (introsort / pdqsort / stl::sort / std::sort)" << std::endl;
+    std::mt19937 gen(1);
+    std::vector<int> src(n), v(n);
+    for (int p = 0; p < 7; ++p) {
+        fill_pattern(src, p, gen);
+        v = src;
+        double old_ms = time_ms([&] { introsort(v.data(), v.data() + n); });
+        v = src;
+        double pdq_ms = time_ms([&] { stl::__pdqsort(v.data(), v.data() + n, stl::less<int>()); });
+        v = src;
+        double sort_ms = time_ms([&] { stl::sort(v.data(), v.data() + n); });
+        v = src;
+        double std_ms = time_ms([&] { std::sort(v.data(), v.data() + n); });
+        std::cout << "  " << names[p] << ":\t" << old_ms << " / " << pdq_ms << " / " << sort_ms
+                  << " / " << std_ms << std::endl;
+    }
+
+    std::cout << "random ints, comparator forms, ms" << std::endl;
+    fill_pattern(src, 0, gen);
+    auto lambda_less = [](int a, int b) { return a < b; };
+    v = src;
+    double intro_lt = time_ms([&] { introsort(v.data(), v.data() + n); });
+    v = src;
+    double intro_comp = time_ms([&] {
+        stl::__introsort_loop(v.data(), v.data() + n, (int*)0, stl::__lg(n) * 2, lambda_less);
+        stl::__final_insertion_sort(v.data(), v.data() + n, lambda_less);
+    });
+    std::cout << "  introsort <: " << intro_lt << ", introsort lambda: " << intro_comp << std::endl;
+    v = src;
+    double sort_less = time_ms([&] { stl::sort(v.data(), v.data() + n, stl::less<int>()); });
+    v = src;
+    double sort_greater = time_ms([&] { stl::sort(v.data(), v.data() + n, stl::greater<int>()); });
+    v = src;
+    double sort_lambda = time_ms([&] { stl::sort(v.data(), v.data() + n, lambda_less); });
+    std::cout << "  sort less: " << sort_less << ", greater: " << sort_greater
+              << ", lambda: " << sort_lambda << std::endl;
+
+    std::cout << "random keys, ms (radix_sort / pdqsort / std::sort)" << std::endl;
+    radix_row<std::uint32_t>("uint32", n, gen);
+    radix_row<std::uint64_t>("uint64", n, gen);
+    radix_row<float>("float", n, gen);
+    radix_row<double>("double", n, gen);
+    return 0;
+}
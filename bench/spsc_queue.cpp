@@ -0,0 +1,143 @@
+#include "../spsc_queue.hpp"
+#include "../queue.hpp"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Pin the calling thread to one CPU so the two sides stay on distinct cores.
+static void pin_to_cpu(unsigned cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % std::thread::hardware_concurrency(), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static volatile long sink;
+
+template<typename Produce, typename Consume>
+static double run_pair(Produce produce, Consume consume)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread producer([&] { pin_to_cpu(0); produce(); });
+    std::thread consumer([&] { pin_to_cpu(1); consume(); });
+    producer.join();
+    consumer.join();
+    return seconds_since(t0);
+}
+
+int main()
+{
+    const long n = 20000000;
+    const std::size_t capacity = 4096;
+
+    std::cout << "producer -> consumer on pinned threads, " << n << " longs" << std::endl;
+
+    {
+        stl::spsc_queue<long> q(capacity);
+        double t = run_pair(
+            [&] { for (long i = 0; i < n; ++i) q.push(i); },
+            [&] {
+                long s = 0, x;
+                for (long i = 0; i < n; ++i) {
+                    for (stl::__backoff wait; !q.try_pop(x); wait()) { }
+                    s += x;
+                }
+                sink = s;
+            });
+        std::cout << "  spsc_queue push/try_pop:      " << n / t / 1e6 << " Mops/s" << std::endl;
+    }
+
+    {
+        const long batch = 64;
+        stl::spsc_queue<long> q(capacity);
+        double t = run_pair(
+            [&] {
+                long in[batch];
+                for (long i = 0; i < n; ) {
+                    long k = 0;
+                    for (; k < batch && i + k < n; ++k)
+                        in[k] = i + k;
+                    long pushed = q.try_push(in, in + k) - in;
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    i += pushed;
+                }
+            },
+            [&] {
+                long s = 0, out[batch];
+                for (long i = 0; i < n; ) {
+                    long k = long(q.try_pop(out, batch));
+                    for (long j = 0; j < k; ++j)
+                        s += out[j];
+                    if (k == 0)
+                        std::this_thread::yield();
+                    i += k;
+                }
+                sink = s;
+            });
+        std::cout << "  spsc_queue batch of " << batch << ":      " << n / t / 1e6 << " Mops/s" << std::endl;
+    }
+
+    {
+        std::mutex m;
+        stl::queue<long> q;
+        double t = run_pair(
+            [&] {
+                for (long i = 0; i < n; ++i) {
+                    std::lock_guard<std::mutex> lock(m);
+                    q.push(i);
+                }
+            },
+            [&] {
+                long s = 0;
+                for (long i = 0; i < n; ) {
+                    bool popped = false;
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        if (!q.empty()) { s += q.front(); q.pop(); popped = true; }
+                    }
+                    if (popped) ++i; else std::this_thread::yield();
+                }
+                sink = s;
+            });
+        std::cout << "  mutex + stl::queue:           " << n / t / 1e6 << " Mops/s" << std::endl;
+    }
+
+    {
+        // round trip: ping on one queue, pong back on the other
+        const long trips = 1000000;
+        stl::spsc_queue<long> ping(capacity), pong(capacity);
+        double t = run_pair(
+            [&] {
+                long x;
+                for (long i = 0; i < trips; ++i) {
+                    ping.push(i);
+                    for (stl::__backoff wait; !pong.try_pop(x); wait()) { }
+                }
+            },
+            [&] {
+                long x;
+                for (long i = 0; i < trips; ++i) {
+                    for (stl::__backoff wait; !ping.try_pop(x); wait()) { }
+                    pong.push(x);
+                }
+            });
+        std::cout << "  round-trip latency:           " << t / trips * 1e9 << " ns" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "../algorithm.hpp"
+#include "../list.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+struct record {
+    int key;
+    int payload;
+};
+
+static bool by_key(const record& x, const record& y) { return x.key < y.key; }
+
+static void fill_pattern(std::vector<record>& v, int pattern, std::mt19937& gen)
+{
+    const int n = int(v.size());
+    for (int i = 0; i < n; ++i) {
+        int key = 0;
+        switch (pattern) {
+        case 0: key = int(gen()); break;
+        case 1: key = i; break;
+        case 2: key = n - i; break;
+        case 3: key = i + int(gen() % 16); break;                   // nearly sorted
+        case 4: key = (i / (n / 16)) % 2 ? n - i : i; break;        // 16 runs, alternating
+        case 5: key = i < n - n / 100 ? i : int(gen() % n); break;  // 1% random tail
+        case 6: key = int(gen() % 16); break;
+        }
+        v[i] = record{key, i};
+    }
+    if (pattern == 7) {
+        // two sorted halves: a single merge
+        for (int i = 0; i < n; ++i)
+            v[i] = record{i < n / 2 ? 2 * i : 2 * (i - n / 2) + 1, i};
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int n = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    const char* names[] = {"random", "sorted", "reversed", "nearly sorted", "16 runs",
+                           "sorted+1% tail", "16 unique", "two halves"};
+
+    std::cout << "stable_sort " << n << " records, ms (top-down merge / stl::stable_sort / "
+                 "std::stable_sort)" << std::endl;
+    std::mt19937 gen(1);
+    std::vector<record> src(n), v(n);
+    for (int p = 0; p < 8; ++p) {
+        fill_pattern(src, p, gen);
+        v = src;
+        // plain top-down merge sort through __merge_adaptive
+        double topdown_ms = time_ms([&] {
+            stl::__temporary_buffer<record*, record> buf(v.data(), (n + 1) / 2);
+            stl::__merge_sort_loop(v.data(), v.data() + n, std::ptrdiff_t(n), buf.begin(),
+                                   std::ptrdiff_t(buf.size()), by_key);
+        });
+        v = src;
+        double stl_ms = time_ms([&] { stl::stable_sort(v.data(), v.data() + n, by_key); });
+        v = src;
+        double std_ms = time_ms([&] { std::stable_sort(v.data(), v.data() + n, by_key); });
+        std::cout << "  " << names[p] << ":\t" << topdown_ms << " / " << stl_ms << " / " << std_ms
+                  << std::endl;
+    }
+
+    const int list_n = n / 10;
+    stl::list<int> ilist;
+    for (int i = 0; i < list_n; ++i)
+        ilist.push_back(int(gen()));
+    std::cout << "merge_sort stl::list<int> of " << list_n << ": "
+              << time_ms([&] { stl::merge_sort(ilist.begin(), ilist.end()); }) << " ms" << std::endl;
+    return 0;
+}
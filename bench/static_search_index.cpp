@@ -0,0 +1,70 @@
+#include "../static_search_index.hpp"
+#include "../algorithm.hpp"
+#include "../vector.hpp"
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <cstddef>
+
+template<typename Function>
+static double time_ms(Function f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static volatile long sink;
+
+int main()
+{
+    // about L1, L2, L3 and DRAM sized arrays of int
+    const std::size_t sizes[] = {4 << 10, 64 << 10, 1 << 20, 16 << 20, 64 << 20};
+    const std::size_t queries = 2000000;
+    std::mt19937 gen(44);
+
+    std::cout << "lower_bound over sorted int, " << queries << " random queries, ns per query"
+              << std::endl
+              << "  elements    std::lower_bound  stl::lower_bound  static_search_index  (build ms)"
+              << std::endl;
+    for (auto n : sizes) {
+        stl::vector<int> sorted;
+        for (std::size_t i = 0; i < n; ++i)
+            sorted.push_back(int(2 * i));
+        std::vector<int> q(queries);
+        for (auto& x : q)
+            x = int(gen() % (2 * n));
+        const int* first = sorted.begin();
+        const int* last = sorted.end();
+
+        double theirs = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += std::lower_bound(first, last, x) - first;
+            sink = s;
+        });
+        double ours = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += stl::lower_bound(first, last, x) - first;
+            sink = s;
+        });
+        stl::static_search_index<int>* index = 0;
+        double build = time_ms([&] { index = new stl::static_search_index<int>(sorted); });
+        double indexed = time_ms([&] {
+            long s = 0;
+            for (auto x : q)
+                s += long(index->lower_bound(x));
+            sink = s;
+        });
+        delete index;
+
+        std::cout << "  " << n << "\t" << theirs * 1e6 / queries << "\t\t    "
+                  << ours * 1e6 / queries << "\t\t      " << indexed * 1e6 / queries
+                  << "\t\t   (" << build << ")" << std::endl;
+    }
+    return 0;
+}
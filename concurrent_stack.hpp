@@ -0,0 +1,113 @@
+#ifndef STL_IMPL_CONCURRENT_STACK_
+#define STL_IMPL_CONCURRENT_STACK_
+
+#include <atomic>
+#include <utility>
+#include "memory/alloc.hpp"
+#include "__epoch.hpp"
+
+namespace stl {
+
+using namespace memory;
+
+// Lock-free LIFO (Treiber stack).
+// push and pop are a single CAS on head.  A popped node is not freed at once:
+// it is retired to __epoch and reused only when no thread can still be
+// reading it, which also rules out ABA on head.  Nodes come from
+// threaded_alloc through __epoch's per-thread block cache.
+template<typename T>
+class concurrent_stack {
+public:
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+protected:
+    struct node : __epoch_node {
+        node* next;
+        value_type data;
+    };
+
+    alignas(__cache_line_size) std::atomic<node*> head;
+
+    static node* get_node() {
+        return static_cast<node*>(__epoch::allocate(sizeof(node)));
+    }
+    static void put_node(node* p) {
+        __epoch::deallocate(p, sizeof(node));
+    }
+    static void reclaim_node(__epoch_node* p) {
+        put_node(static_cast<node*>(p));
+    }
+
+public:
+    concurrent_stack() : head(0) { }
+    concurrent_stack(const concurrent_stack&) = delete;
+    concurrent_stack& operator=(const concurrent_stack&) = delete;
+    // No other thread may use the stack any more.
+    ~concurrent_stack() {
+        node* p = head.load(std::memory_order_acquire);
+        while (p) {
+            node* next = p->next;
+            memory::destroy(&p->data);
+            put_node(p);
+            p = next;
+        }
+    }
+
+public:
+    // A snapshot, like every observer of a concurrent container.
+    bool empty() const { return head.load(std::memory_order_acquire) == 0; }
+
+    template<typename... Args>
+    void emplace(Args&&... args);
+    void push(const value_type& x) { emplace(x); }
+    void push(value_type&& x) { emplace(std::move(x)); }
+
+    // Moves the top element into x; false if the stack was empty.
+    bool try_pop(value_type& x);
+};
+
+template<typename T>
+template<typename... Args>
+void concurrent_stack<T>::emplace(Args&&... args)
+{
+    node* p = get_node();
+    try {
+        construct(&p->data, std::forward<Args>(args)...);
+    }
+    catch (...) {
+        put_node(p);
+        throw;
+    }
+    p->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(p->next, p, std::memory_order_release,
+                                       std::memory_order_relaxed)) { }
+}
+
+template<typename T>
+bool concurrent_stack<T>::try_pop(value_type& x)
+{
+    __epoch::guard pinned;
+    node* p = head.load(std::memory_order_acquire);
+    // p->next is safe to read: p cannot be reclaimed while we are pinned
+    while (p && !head.compare_exchange_weak(p, p->next, std::memory_order_acquire,
+                                            std::memory_order_acquire)) { }
+    if (!p)
+        return false;
+    try {
+        x = std::move(p->data);
+    }
+    catch (...) {
+        memory::destroy(&p->data);
+        pinned.retire(p, reclaim_node);
+        throw;
+    }
+    memory::destroy(&p->data);
+    pinned.retire(p, reclaim_node);
+    return true;
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_CONCURRENT_STACK_ */
@@ -2,6 +2,7 @@
 #define STL_IMPL_DEQUE_
 
 #include <cstddef>
+#include <type_traits>
 #include "memory/alloc.hpp"
 #include "iterator.hpp"
 #include <algorithm>
@@ -10,16 +11,35 @@ namespace stl {
 
 using namespace memory;
 
+// Default buffer length (in elements).
+// Small elements get 512-byte buffers (eight cache lines), so short queues
+// stay cheap; anything wider than 16 bytes gets page-sized buffers, and no
+// buffer holds fewer than 8 elements, so large T does not degrade into a
+// linked list of single-element nodes.
+enum { __deque_small_buf = 512, __deque_page_buf = 4096, __deque_min_buf_elems = 8 };
+
 inline std::size_t __deque_buf_size(std::size_t n, std::size_t sz)
 {
-    return n != 0 ? n : (sz < 512 ? std::size_t(512 / sz) : std::size_t(1));
+    if (n != 0)
+        return n;
+    if (sz <= 16)
+        return std::size_t(__deque_small_buf) / sz;
+    std::size_t elems = std::size_t(__deque_page_buf) / sz;
+    return elems > std::size_t(__deque_min_buf_elems) ? elems : std::size_t(__deque_min_buf_elems);
 }
 
+// Buffer length chosen per deque instance, e.g.
+//   stl::deque<int> q(stl::deque_buffer_size(16));
+// zero falls back to the BufSiz template argument / __deque_buf_size.
+struct deque_buffer_size {
+    explicit deque_buffer_size(std::size_t n) : elements(n) { }
+    std::size_t elements;
+};
+
 template<typename T, typename Ref, typename Ptr, std::size_t BufSiz>
 struct __deque_iterator {
     typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
     typedef __deque_iterator<T, const T&, const T*, BufSiz> const_iterator;
-    static std::size_t buffer_size() { return __deque_buf_size(BufSiz, sizeof(T)); }
 
     typedef random_access_iterator_tag iterator_category;
     typedef T value_type;
@@ -36,10 +56,17 @@ struct __deque_iterator {
     T* last;
     map_pointer node;
 
+    // All buffers of one deque have the same length, which may be chosen at
+    // run time, so the iterator carries it as last - first.
+    difference_type buffer_size() const { return last - first; }
+
     void set_node(map_pointer new_node) {
+        set_node(new_node, buffer_size());
+    }
+    void set_node(map_pointer new_node, difference_type buf_size) {
         node = new_node;
         first = *new_node;
-        last = first + difference_type(buffer_size());
+        last = first + buf_size;
     }
 
     reference operator*() const { return *cur; }
@@ -109,6 +136,41 @@ struct __deque_iterator {
 
 };
 
+// A segment of a deque is one map slot plus the (per deque) buffer length
+template<typename T>
+struct __deque_segment {
+    T** node;
+    std::ptrdiff_t buf_size;
+
+    __deque_segment& operator++() {
+        ++node;
+        return *this;
+    }
+    bool operator==(const __deque_segment& x) const { return node == x.node; }
+    bool operator!=(const __deque_segment& x) const { return node != x.node; }
+};
+
+template<typename T, typename Ref, typename Ptr, std::size_t BufSiz>
+struct __segmented_iterator_traits<__deque_iterator<T, Ref, Ptr, BufSiz>> {
+    typedef __traits::__true_type is_segmented_iterator;
+    typedef __deque_iterator<T, Ref, Ptr, BufSiz> iterator;
+    typedef __deque_segment<T> segment_iterator;
+    typedef T* local_iterator;
+
+    static segment_iterator segment(const iterator& it) {
+        return segment_iterator{it.node, it.buffer_size()};
+    }
+    static local_iterator local(const iterator& it) { return it.cur; }
+    static local_iterator begin(segment_iterator s) { return *s.node; }
+    static local_iterator end(segment_iterator s) { return *s.node + s.buf_size; }
+    static iterator compose(segment_iterator s, local_iterator l) {
+        iterator it;
+        it.set_node(s.node, s.buf_size);
+        it.cur = l;
+        return it;
+    }
+};
+
 template<typename T, typename Alloc = alloc, std::size_t BufSiz = 0>
 class deque {
 public:
@@ -130,6 +192,7 @@ protected:
     map_pointer map;
 
     size_type map_size;
+    size_type buf_size;     // elements per buffer
 
 public:
     iterator begin() { return start; }
@@ -148,6 +211,7 @@ public:
 
     size_type size() const { return finish - start; }
     size_type max_size() const { return size_type(-1); }
+    size_type buffer_size() const { return buf_size; }
     bool empty() const { return finish == start; }
 
 protected:
@@ -155,8 +219,20 @@ protected:
     typedef simple_alloc<pointer, Alloc> map_allocator;
 
     void fill_initialize(size_type n, const value_type& value);
+    template<typename Integer>
+    void initialize_dispatch(Integer n, Integer x, __traits::__true_type) {
+        fill_initialize(size_type(n), value_type(x));
+    }
+    template<typename InputIterator>
+    void initialize_dispatch(InputIterator first, InputIterator last, __traits::__false_type) {
+        range_initialize(first, last, iterator_category(first));
+    }
+    template<typename InputIterator>
+    void range_initialize(InputIterator first, InputIterator last, input_iterator_tag);
+    template<typename ForwardIterator>
+    void range_initialize(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
     void create_map_and_nodes(size_type num_elements);
-    size_type buffer_size() {
+    size_type default_buffer_size() const {
         return __deque_buf_size(BufSiz, sizeof(value_type));
     }
     size_type initial_map_size() {
@@ -166,25 +242,94 @@ protected:
         return data_allocator::allocate(buffer_size());
     }
     void deallocate_node(value_type *p) {
-        destroy(p);
-        data_allocator::deallocate(p);
+        data_allocator::deallocate(p, buffer_size());
+    }
+    map_pointer allocate_map(size_type n) {
+        map_pointer result = map_allocator::allocate(n);
+        std::fill(result, result + n, pointer(0));
+        return result;
     }
 
+    // Spare-block cache.
+    // Every map slot outside [start.node, finish.node] is either null or
+    // holds a spare buffer.  At most one spare is kept on each side, in the
+    // slot right next to the live range, so a deque oscillating around a
+    // block boundary (or a FIFO moving blocks from front to back) does not
+    // go back to the allocator on every crossing.
+
+    // slot `offset` places away from `node`, or null outside the map
+    map_pointer map_slot(map_pointer node, difference_type offset) const {
+        difference_type index = (node - map) + offset;
+        return index >= 0 && index < difference_type(map_size) ? map + index : 0;
+    }
+    pointer take_node(map_pointer slot, map_pointer other_spare);
+    void shelve_node(map_pointer stale, map_pointer other_spare);
+    void release_node(map_pointer slot) {
+        deallocate_node(*slot);
+        *slot = 0;
+    }
+    void release_spare_nodes();
+
 public:
     deque() : deque(0, T()) {}
     deque(int n, const value_type& value)
-     : start(), finish(), map(0), map_size(0)
+     : start(), finish(), map(0), map_size(0), buf_size(default_buffer_size())
     {
         fill_initialize(n, value);
     }
     template<typename InputIterator>
-    deque(InputIterator first, InputIterator last) : deque() {
-        for ( ; first != last; ++first) {
-            push_back(*first);
-        }
+    deque(InputIterator first, InputIterator last)
+     : start(), finish(), map(0), map_size(0), buf_size(default_buffer_size())
+    {
+        typedef typename std::conditional<std::is_integral<InputIterator>::value,
+                                          __traits::__true_type,
+                                          __traits::__false_type>::type is_integer;
+        initialize_dispatch(first, last, is_integer());
     }
     explicit deque(size_type n)
      : deque(n, T()) { }
+    explicit deque(deque_buffer_size bs)
+     : start(), finish(), map(0), map_size(0),
+       buf_size(bs.elements != 0 ? bs.elements : default_buffer_size())
+    {
+        create_map_and_nodes(0);
+    }
+    deque(const deque& x)
+     : start(), finish(), map(0), map_size(0), buf_size(x.buf_size)
+    {
+        range_initialize(x.start, x.finish, random_access_iterator_tag());
+    }
+    deque(deque&& x) : deque() {
+        swap(x);
+    }
+    deque& operator=(const deque& x) {
+        if (this != &x) {
+            deque tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    deque& operator=(deque&& x) {
+        if (this != &x) {
+            clear();
+            swap(x);
+        }
+        return *this;
+    }
+    ~deque() {
+        clear();
+        release_node(start.node);
+        release_spare_nodes();
+        map_allocator::deallocate(map, map_size);
+    }
+
+    void swap(deque& x) {
+        std::swap(start, x.start);
+        std::swap(finish, x.finish);
+        std::swap(map, x.map);
+        std::swap(map_size, x.map_size);
+        std::swap(buf_size, x.buf_size);
+    }
 
 public:
     void push_back(const value_type& t) {
@@ -203,10 +348,35 @@ public:
         else
             push_front_aux(t);
     }
+    void push_back(value_type&& t) { emplace_back(std::move(t)); }
+    void push_front(value_type&& t) { emplace_front(std::move(t)); }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (finish.cur != finish.last - 1) {
+            construct(finish.cur, std::forward<Args>(args)...);
+            ++finish.cur;
+        }
+        else
+            emplace_back_aux(std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        if (start.cur != start.first) {
+            construct(start.cur - 1, std::forward<Args>(args)...);
+            --start.cur;
+        }
+        else
+            emplace_front_aux(std::forward<Args>(args)...);
+    }
 
 protected:
     void push_back_aux(const value_type&);
     void push_front_aux(const value_type&);
+    template<typename... Args>
+    void emplace_back_aux(Args&&... args);
+    template<typename... Args>
+    void emplace_front_aux(Args&&... args);
 
 protected:
     void reserve_map_at_back(size_type nodes_to_add = 1) {
@@ -219,18 +389,37 @@ protected:
     }
     void reallocate_map(size_type nodes_to_add, bool add_at_front);
 
+    // Make room for n elements in front of start / behind finish, with
+    // every buffer in place, and return the would-be new start / finish.
+    iterator reserve_elements_at_front(size_type n) {
+        size_type vacancies = start.cur - start.first;
+        if (n > vacancies)
+            new_elements_at_front(n - vacancies);
+        return start - difference_type(n);
+    }
+    iterator reserve_elements_at_back(size_type n) {
+        size_type vacancies = (finish.last - finish.cur) - 1;
+        if (n > vacancies)
+            new_elements_at_back(n - vacancies);
+        return finish + difference_type(n);
+    }
+    void new_elements_at_front(size_type new_elements);
+    void new_elements_at_back(size_type new_elements);
+    void destroy_nodes_at_front(iterator before_start);
+    void destroy_nodes_at_back(iterator after_finish);
+
 public:
     void pop_back() {
         if (finish.cur != finish.first) {
             --finish.cur;
-            destroy(finish.cur);
+            memory::destroy(finish.cur);
         } else {
             pop_back_aux();
         }
     }
     void pop_front() {
         if(start.cur != start.last - 1) {
-            destroy(start.cur);
+            memory::destroy(start.cur);
             ++start.cur;
         } else {
             pop_front_aux();
@@ -270,7 +459,36 @@ public:
             return insert_aux(position, x);
         }
     }
+    void insert(iterator pos, size_type n, const value_type& x);
+    // insert(pos, 3, 1) picks the template; integers mean n copies of x
+    template<typename InputIterator>
+    void insert(iterator pos, InputIterator first, InputIterator last) {
+        typedef typename std::conditional<std::is_integral<InputIterator>::value,
+                                          __traits::__true_type,
+                                          __traits::__false_type>::type is_integer;
+        insert_dispatch(pos, first, last, is_integer());
+    }
     iterator insert_aux(iterator pos, const value_type& x);
+
+protected:
+    void insert_aux(iterator pos, size_type n, const value_type& x);
+    template<typename ForwardIterator>
+    void insert_aux(iterator pos, ForwardIterator first, ForwardIterator last, size_type n);
+    template<typename Integer>
+    void insert_dispatch(iterator pos, Integer n, Integer x, __traits::__true_type) {
+        insert(pos, size_type(n), value_type(x));
+    }
+    template<typename InputIterator>
+    void insert_dispatch(iterator pos, InputIterator first, InputIterator last,
+                         __traits::__false_type) {
+        range_insert(pos, first, last, iterator_category(first));
+    }
+    template<typename InputIterator>
+    void range_insert(iterator pos, InputIterator first, InputIterator last,
+                      input_iterator_tag);
+    template<typename ForwardIterator>
+    void range_insert(iterator pos, ForwardIterator first, ForwardIterator last,
+                      forward_iterator_tag);
 };
 
 template<typename T, typename Alloc, std::size_t BufSiz>
@@ -280,21 +498,47 @@ void deque<T, Alloc, BufSiz>::fill_initialize(size_type n, const value_type& val
     map_pointer cur;
     try {
         for (cur = start.node; cur < finish.node; ++cur) {
-            uninitialized_fill(*cur, *cur + buffer_size(), value);
+            memory::uninitialized_fill(*cur, *cur + buffer_size(), value);
         }
-        uninitialized_fill(finish.first, finish.cur, value);
+        memory::uninitialized_fill(finish.first, finish.cur, value);
     } catch (...) {
         throw;
     }
 }
 
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename InputIterator>
+void deque<T, Alloc, BufSiz>::range_initialize(InputIterator first, InputIterator last,
+                                               input_iterator_tag)
+{
+    create_map_and_nodes(0);
+    for ( ; first != last; ++first)
+        push_back(*first);
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename ForwardIterator>
+void deque<T, Alloc, BufSiz>::range_initialize(ForwardIterator first, ForwardIterator last,
+                                               forward_iterator_tag)
+{
+    size_type n = stl::distance(first, last);
+    create_map_and_nodes(n);
+    for (map_pointer cur = start.node; cur < finish.node; ++cur) {
+        ForwardIterator mid = first;
+        stl::advance(mid, buffer_size());
+        memory::uninitialized_copy(first, mid, *cur);
+        first = mid;
+    }
+    memory::uninitialized_copy(first, last, finish.first);
+}
+
 template<typename T, typename Alloc, std::size_t BufSiz>
 void deque<T, Alloc, BufSiz>::create_map_and_nodes(size_type num_elements)
 {
     size_type num_nodes = num_elements / buffer_size() + 1;
 
     map_size = std::max(initial_map_size(), num_nodes + 2);
-    map = map_allocator::allocate(map_size);
+    map = allocate_map(map_size);
     
     map_pointer nstart = map + (map_size - num_nodes) / 2;
     map_pointer nfinish = nstart + num_nodes - 1;
@@ -308,8 +552,8 @@ void deque<T, Alloc, BufSiz>::create_map_and_nodes(size_type num_elements)
         throw;
     }
 
-    start.set_node(nstart);
-    finish.set_node(nfinish);
+    start.set_node(nstart, buffer_size());
+    finish.set_node(nfinish, buffer_size());
     start.cur = start.first;
     finish.cur = finish.first + num_elements % buffer_size();
 }
@@ -319,19 +563,11 @@ void deque<T, Alloc, BufSiz>::push_back_aux(const value_type& t)
 {
     value_type t_copy {t};
     reserve_map_at_back();
-    *(finish.node + 1) = allocate_node();
-    try {
-        construct(finish.cur, t_copy);
-        finish.set_node(finish.node + 1);
-        finish.cur = finish.first;
-    }
-    catch (...) {
-        // commit or rollback
-        finish.set_node(finish.node - 1);
-        finish.cur = finish.last;
-        deallocate_node(*(finish.node + 1));
-        throw;
-    }
+    *(finish.node + 1) = take_node(finish.node + 1, map_slot(start.node, -1));
+    // on failure the new buffer simply stays behind as a spare
+    construct(finish.cur, t_copy);
+    finish.set_node(finish.node + 1);
+    finish.cur = finish.first;
 }
 
 template<typename T, typename Alloc, std::size_t BufSiz>
@@ -339,26 +575,94 @@ void deque<T, Alloc, BufSiz>::push_front_aux(const value_type& t)
 {
     value_type t_copy {t};
     reserve_map_at_front();
-    *(start.node - 1) = allocate_node();
+    *(start.node - 1) = take_node(start.node - 1, map_slot(finish.node, 1));
     try {
         start.set_node(start.node - 1);
         start.cur = start.last - 1;
         construct(start.cur, t_copy);
     }
     catch (...) {
+        // commit or rollback, keeping the new buffer as a spare
         start.set_node(start.node + 1);
         start.cur = start.first;
-        deallocate_node(*(finish.node - 1));
         throw;
     }
 }
 
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename... Args>
+void deque<T, Alloc, BufSiz>::emplace_back_aux(Args&&... args)
+{
+    reserve_map_at_back();
+    *(finish.node + 1) = take_node(finish.node + 1, map_slot(start.node, -1));
+    construct(finish.cur, std::forward<Args>(args)...);
+    finish.set_node(finish.node + 1);
+    finish.cur = finish.first;
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename... Args>
+void deque<T, Alloc, BufSiz>::emplace_front_aux(Args&&... args)
+{
+    reserve_map_at_front();
+    *(start.node - 1) = take_node(start.node - 1, map_slot(finish.node, 1));
+    construct(*(start.node - 1) + (buffer_size() - 1), std::forward<Args>(args)...);
+    start.set_node(start.node - 1);
+    start.cur = start.last - 1;
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::new_elements_at_front(size_type new_elements)
+{
+    size_type new_nodes = (new_elements + buffer_size() - 1) / buffer_size();
+    reserve_map_at_front(new_nodes);
+    for (size_type i = 1; i <= new_nodes; ++i)
+        *(start.node - i) = take_node(start.node - i, map_slot(finish.node, 1));
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::new_elements_at_back(size_type new_elements)
+{
+    size_type new_nodes = (new_elements + buffer_size() - 1) / buffer_size();
+    reserve_map_at_back(new_nodes);
+    for (size_type i = 1; i <= new_nodes; ++i)
+        *(finish.node + i) = take_node(finish.node + i, map_slot(start.node, -1));
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::destroy_nodes_at_front(iterator before_start)
+{
+    // rollback of reserve_elements_at_front, the nearest buffer stays as spare
+    for (map_pointer cur = before_start.node; cur + 1 < start.node; ++cur)
+        release_node(cur);
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::destroy_nodes_at_back(iterator after_finish)
+{
+    // rollback of reserve_elements_at_back, the nearest buffer stays as spare
+    for (map_pointer cur = after_finish.node; cur > finish.node + 1; --cur)
+        release_node(cur);
+}
+
 template<typename T, typename Alloc, std::size_t BufSiz>
 void deque<T, Alloc, BufSiz>::reallocate_map(size_type nodes_to_add, bool add_at_front)
 {
     size_type old_num_nodes = finish.node - start.node + 1;
     size_type new_num_nodes = old_num_nodes + nodes_to_add;
 
+    // lift the spares out of the map, they are put back next to the
+    // relocated live range afterwards
+    pointer front_spare = 0, back_spare = 0;
+    if (map_pointer slot = map_slot(start.node, -1)) {
+        front_spare = *slot;
+        *slot = 0;
+    }
+    if (map_pointer slot = map_slot(finish.node, 1)) {
+        back_spare = *slot;
+        *slot = 0;
+    }
+
     map_pointer new_nstart;
     if (map_size > 2 * new_num_nodes) {
         new_nstart = map + (map_size - new_num_nodes) / 2
@@ -367,10 +671,12 @@ void deque<T, Alloc, BufSiz>::reallocate_map(size_type nodes_to_add, bool add_at
             std::copy(start.node, finish.node + 1, new_nstart);
         else
             std::copy_backward(start.node, finish.node + 1, new_nstart + old_num_nodes);
+        std::fill(map, new_nstart, pointer(0));
+        std::fill(new_nstart + old_num_nodes, map + map_size, pointer(0));
     }
     else {
         size_type new_map_size = map_size + std::max(map_size, nodes_to_add) + 2;
-        map_pointer new_map = map_allocator::allocate(new_map_size);
+        map_pointer new_map = allocate_map(new_map_size);
         new_nstart = new_map + (new_map_size - new_num_nodes) / 2
                 + (add_at_front ? nodes_to_add : 0);
         std::copy(start.node, finish.node + 1, new_nstart);
@@ -381,39 +687,95 @@ void deque<T, Alloc, BufSiz>::reallocate_map(size_type nodes_to_add, bool add_at
 
     start.set_node(new_nstart);
     finish.set_node(new_nstart + old_num_nodes - 1);
+
+    if (front_spare) {
+        if (map_pointer slot = map_slot(start.node, -1))
+            *slot = front_spare;
+        else
+            deallocate_node(front_spare);
+    }
+    if (back_spare) {
+        if (map_pointer slot = map_slot(finish.node, 1))
+            *slot = back_spare;
+        else
+            deallocate_node(back_spare);
+    }
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+typename deque<T, Alloc, BufSiz>::pointer
+deque<T, Alloc, BufSiz>::take_node(map_pointer slot, map_pointer other_spare)
+{
+    if (*slot)
+        return *slot;
+    if (other_spare && *other_spare) {
+        pointer p = *other_spare;
+        *other_spare = 0;
+        return p;
+    }
+    return allocate_node();
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::shelve_node(map_pointer stale, map_pointer other_spare)
+{
+    // `stale` has just drifted two slots away from the live range
+    if (!stale || !*stale)
+        return ;
+    if (other_spare && !*other_spare)
+        *other_spare = *stale;
+    else
+        deallocate_node(*stale);
+    *stale = 0;
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::release_spare_nodes()
+{
+    for (map_pointer cur = map; cur < start.node; ++cur)
+        if (*cur) release_node(cur);
+    for (map_pointer cur = finish.node + 1; cur < map + map_size; ++cur)
+        if (*cur) release_node(cur);
 }
 
 template<typename T, typename Alloc, std::size_t BufSiz>
 void deque<T, Alloc, BufSiz>::pop_back_aux()
 {
-    deallocate_node(finish.first);
+    // the emptied buffer stays in its slot as the back spare
     finish.set_node(finish.node - 1);
     finish.cur = finish.last - 1;
-    destroy(finish.cur);
+    memory::destroy(finish.cur);
+    shelve_node(map_slot(finish.node, 2), map_slot(start.node, -1));
 }
 
 template<typename T, typename Alloc, std::size_t BufSiz>
 void deque<T, Alloc, BufSiz>::pop_front_aux()
 {
-    destroy(start.cur);
-    deallocate_node(start.first);
+    // the emptied buffer stays in its slot as the front spare
+    memory::destroy(start.cur);
     start.set_node(start.node + 1);
     start.cur = start.first;
+    shelve_node(map_slot(start.node, -2), map_slot(finish.node, 1));
 }
 
 template<typename T, typename Alloc, std::size_t BufSiz>
 void deque<T, Alloc, BufSiz>::clear()
 {
+    // the buffer right after start becomes the back spare
+    map_pointer back_spare = start.node + 1;
     for (auto node = start.node + 1; node < finish.node; ++node) {
-        destroy(*node, *node + buffer_size());
-        data_allocator::deallocate(*node, buffer_size());
+        memory::destroy(*node, *node + buffer_size());
+        if (node != back_spare) release_node(node);
     }
     if (start.node != finish.node) {
-        destroy(start.cur, start.last);
-        destroy(finish.first, finish.cur);
-        data_allocator::deallocate(finish.first, buffer_size());
+        memory::destroy(start.cur, start.last);
+        memory::destroy(finish.first, finish.cur);
+        if (finish.node != back_spare) release_node(finish.node);
+        map_pointer old_spare = map_slot(finish.node, 1);
+        if (old_spare && *old_spare)
+            release_node(old_spare);
     } else {
-        destroy(start.cur, finish.cur);
+        memory::destroy(start.cur, finish.cur);
     }
     finish = start;
 }
@@ -431,16 +793,28 @@ deque<T, Alloc, BufSiz>::erase(iterator first, iterator last)
         if (elems_before < (size() - n) / 2) {
             std::copy_backward(start, first, last);
             iterator new_start = start + n;
-            destroy(start, new_start);
-            for (auto cur = start.node; cur < new_start.node; ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
+            memory::destroy(start, new_start);
+            if (start.node != new_start.node) {
+                // keep the buffer next to new_start as the front spare
+                for (auto cur = start.node; cur + 1 < new_start.node; ++cur)
+                    release_node(cur);
+                map_pointer old_spare = map_slot(start.node, -1);
+                if (old_spare && *old_spare)
+                    release_node(old_spare);
+            }
             start = new_start;
         } else {
             std::copy(last, finish, first);
             iterator new_finish = finish - n;
-            destroy(new_finish, finish);
-            for (auto cur = new_finish.node + 1; cur <= finish.node; ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
+            memory::destroy(new_finish, finish);
+            if (new_finish.node != finish.node) {
+                // keep the buffer next to new_finish as the back spare
+                for (auto cur = new_finish.node + 2; cur <= finish.node; ++cur)
+                    release_node(cur);
+                map_pointer old_spare = map_slot(finish.node, 1);
+                if (old_spare && *old_spare)
+                    release_node(old_spare);
+            }
             finish = new_finish;
         }
         return start + elems_before;
@@ -477,6 +851,192 @@ deque<T, Alloc, BufSiz>::insert_aux(iterator pos, const value_type& x)
     return pos;
 }
 
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::insert(iterator pos, size_type n, const value_type& x)
+{
+    if (pos.cur == start.cur) {
+        iterator new_start = reserve_elements_at_front(n);
+        try {
+            memory::uninitialized_fill(new_start, start, x);
+            start = new_start;
+        }
+        catch (...) {
+            destroy_nodes_at_front(new_start);
+            throw;
+        }
+    } else if (pos.cur == finish.cur) {
+        iterator new_finish = reserve_elements_at_back(n);
+        try {
+            memory::uninitialized_fill(finish, new_finish, x);
+            finish = new_finish;
+        }
+        catch (...) {
+            destroy_nodes_at_back(new_finish);
+            throw;
+        }
+    } else {
+        insert_aux(pos, n, x);
+    }
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename InputIterator>
+void deque<T, Alloc, BufSiz>::range_insert(iterator pos, InputIterator first, InputIterator last,
+                                           input_iterator_tag)
+{
+    for ( ; first != last; ++first) {
+        pos = insert(pos, *first);
+        ++pos;
+    }
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename ForwardIterator>
+void deque<T, Alloc, BufSiz>::range_insert(iterator pos, ForwardIterator first, ForwardIterator last,
+                                           forward_iterator_tag)
+{
+    size_type n = stl::distance(first, last);
+    if (pos.cur == start.cur) {
+        iterator new_start = reserve_elements_at_front(n);
+        try {
+            memory::uninitialized_copy(first, last, new_start);
+            start = new_start;
+        }
+        catch (...) {
+            destroy_nodes_at_front(new_start);
+            throw;
+        }
+    } else if (pos.cur == finish.cur) {
+        iterator new_finish = reserve_elements_at_back(n);
+        try {
+            memory::uninitialized_copy(first, last, finish);
+            finish = new_finish;
+        }
+        catch (...) {
+            destroy_nodes_at_back(new_finish);
+            throw;
+        }
+    } else {
+        insert_aux(pos, first, last, n);
+    }
+}
+
+// Both insert_aux overloads below open a gap of n elements on the shorter
+// side of pos: the buffers are reserved once and every element on that side
+// is moved exactly once.
+template<typename T, typename Alloc, std::size_t BufSiz>
+void deque<T, Alloc, BufSiz>::insert_aux(iterator pos, size_type n, const value_type& x)
+{
+    const difference_type elems_before = pos - start;
+    const size_type length = size();
+    value_type x_copy {x};
+    if (elems_before < difference_type(length / 2)) {
+        iterator new_start = reserve_elements_at_front(n);
+        iterator old_start = start;
+        pos = start + elems_before;
+        try {
+            if (elems_before >= difference_type(n)) {
+                iterator start_n = start + difference_type(n);
+                memory::uninitialized_copy(start, start_n, new_start);
+                start = new_start;
+                std::copy(start_n, pos, old_start);
+                std::fill(pos - difference_type(n), pos, x_copy);
+            } else {
+                iterator mid = memory::uninitialized_copy(start, pos, new_start);
+                memory::uninitialized_fill(mid, start, x_copy);
+                start = new_start;
+                std::fill(old_start, pos, x_copy);
+            }
+        }
+        catch (...) {
+            destroy_nodes_at_front(new_start);
+            throw;
+        }
+    } else {
+        iterator new_finish = reserve_elements_at_back(n);
+        iterator old_finish = finish;
+        const difference_type elems_after = difference_type(length) - elems_before;
+        pos = finish - elems_after;
+        try {
+            if (elems_after > difference_type(n)) {
+                iterator finish_n = finish - difference_type(n);
+                memory::uninitialized_copy(finish_n, finish, finish);
+                finish = new_finish;
+                std::copy_backward(pos, finish_n, old_finish);
+                std::fill(pos, pos + difference_type(n), x_copy);
+            } else {
+                memory::uninitialized_fill(finish, pos + difference_type(n), x_copy);
+                memory::uninitialized_copy(pos, finish, pos + difference_type(n));
+                finish = new_finish;
+                std::fill(pos, old_finish, x_copy);
+            }
+        }
+        catch (...) {
+            destroy_nodes_at_back(new_finish);
+            throw;
+        }
+    }
+}
+
+template<typename T, typename Alloc, std::size_t BufSiz>
+template<typename ForwardIterator>
+void deque<T, Alloc, BufSiz>::insert_aux(iterator pos, ForwardIterator first,
+                                         ForwardIterator last, size_type n)
+{
+    const difference_type elems_before = pos - start;
+    const size_type length = size();
+    if (elems_before < difference_type(length / 2)) {
+        iterator new_start = reserve_elements_at_front(n);
+        iterator old_start = start;
+        pos = start + elems_before;
+        try {
+            if (elems_before >= difference_type(n)) {
+                iterator start_n = start + difference_type(n);
+                memory::uninitialized_copy(start, start_n, new_start);
+                start = new_start;
+                std::copy(start_n, pos, old_start);
+                std::copy(first, last, pos - difference_type(n));
+            } else {
+                ForwardIterator mid = first;
+                stl::advance(mid, difference_type(n) - elems_before);
+                iterator gap = memory::uninitialized_copy(start, pos, new_start);
+                memory::uninitialized_copy(first, mid, gap);
+                start = new_start;
+                std::copy(mid, last, old_start);
+            }
+        }
+        catch (...) {
+            destroy_nodes_at_front(new_start);
+            throw;
+        }
+    } else {
+        iterator new_finish = reserve_elements_at_back(n);
+        iterator old_finish = finish;
+        const difference_type elems_after = difference_type(length) - elems_before;
+        pos = finish - elems_after;
+        try {
+            if (elems_after > difference_type(n)) {
+                iterator finish_n = finish - difference_type(n);
+                memory::uninitialized_copy(finish_n, finish, finish);
+                finish = new_finish;
+                std::copy_backward(pos, finish_n, old_finish);
+                std::copy(first, last, pos);
+            } else {
+                ForwardIterator mid = first;
+                stl::advance(mid, elems_after);
+                iterator gap = memory::uninitialized_copy(mid, last, finish);
+                memory::uninitialized_copy(pos, finish, gap);
+                finish = new_finish;
+                std::copy(first, mid, pos);
+            }
+        }
+        catch (...) {
+            destroy_nodes_at_back(new_finish);
+            throw;
+        }
+    }
+}
+
 }
 
 #endif /* STL_IMPL_DEQUE_ */
\ No newline at end of file
@@ -0,0 +1,520 @@
+#ifndef STL_IMPL_EXECUTION_
+#define STL_IMPL_EXECUTION_
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include "iterator.hpp"
+#include "algobase.hpp"
+#include "algorithm.hpp"
+#include "numeric.hpp"
+#include "thread_pool.hpp"
+
+namespace stl {
+
+// Execution policies
+// seq runs the ordinary algorithm.  par and par_unseq split a random-access
+// range into blocks of grain elements and run the blocks on a thread_pool
+// (thread_pool::default_pool() unless one is given with on()); the grain is
+// picked from the range size and the pool width unless set with
+// grain_size().  par_unseq is accepted for compatibility and behaves like par:
+// a block is a plain loop the compiler is free to vectorize either way.
+// Ranges that are not random access fall back to the sequential algorithm.
+namespace execution {
+
+template<typename Policy>
+struct __parallel_policy_base {
+    thread_pool* pool;
+    std::size_t grain;
+
+    Policy on(thread_pool& p) const {
+        Policy x;
+        x.pool = &p;
+        x.grain = grain;
+        return x;
+    }
+    Policy grain_size(std::size_t g) const {
+        Policy x;
+        x.pool = pool;
+        x.grain = g;
+        return x;
+    }
+};
+
+struct sequenced_policy { };
+struct parallel_policy : __parallel_policy_base<parallel_policy> { };
+struct parallel_unsequenced_policy : __parallel_policy_base<parallel_unsequenced_policy> { };
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+}  // end of namespace execution
+
+template<typename T> struct is_execution_policy : std::false_type { };
+template<> struct is_execution_policy<execution::sequenced_policy> : std::true_type { };
+template<> struct is_execution_policy<execution::parallel_policy> : std::true_type { };
+template<> struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type { };
+
+template<typename ExecutionPolicy, typename T>
+using __enable_if_execution_policy =
+    typename std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T>::type;
+
+// smallest automatic grain: below this the task overhead dominates
+enum { __min_parallel_grain = 4096 };
+
+template<typename Policy>
+inline thread_pool& __policy_pool(const execution::__parallel_policy_base<Policy>& policy) {
+    return policy.pool ? *policy.pool : thread_pool::default_pool();
+}
+
+template<typename Policy>
+inline std::size_t __policy_grain(const execution::__parallel_policy_base<Policy>& policy,
+                                  thread_pool& pool, std::size_t n) {
+    if (policy.grain)
+        return policy.grain;
+    std::size_t g = n / (pool.concurrency() * 8);
+    return g < std::size_t(__min_parallel_grain) ? std::size_t(__min_parallel_grain) : g;
+}
+
+// Runs f(lo, hi) over the blocks of [0, n) as the policy says.
+template<typename Policy, typename Function>
+inline void __parallel_blocks(const execution::__parallel_policy_base<Policy>& policy,
+                              std::size_t n, Function f) {
+    thread_pool& pool = __policy_pool(policy);
+    pool.parallel_for(n, __policy_grain(policy, pool, n), f);
+}
+
+inline bool __all_random_access(random_access_iterator_tag) { return true; }
+template<typename Category>
+inline bool __all_random_access(Category) { return false; }
+template<typename Category, typename... Categories>
+inline bool __all_random_access(Category c, Categories... cs) {
+    return __all_random_access(c) && __all_random_access(cs...);
+}
+
+// The parallel bodies.  They are only instantiated for random-access
+// iterators; the dispatchers below check the categories.
+
+template<typename Policy, typename RandomAccessIterator, typename Function>
+void __par_for_each(const Policy& policy, RandomAccessIterator first,
+                    RandomAccessIterator last, Function f, random_access_iterator_tag) {
+    __parallel_blocks(policy, last - first, [&](std::size_t lo, std::size_t hi) {
+        stl::for_each(first + lo, first + hi, f);
+    });
+}
+template<typename Policy, typename InputIterator, typename Function>
+inline void __par_for_each(const Policy&, InputIterator first, InputIterator last,
+                           Function f, input_iterator_tag) {
+    stl::for_each(first, last, f);
+}
+
+template<typename Policy, typename RandomAccessIterator, typename T>
+void __par_fill(const Policy& policy, RandomAccessIterator first, RandomAccessIterator last,
+                const T& value, random_access_iterator_tag) {
+    __parallel_blocks(policy, last - first, [&](std::size_t lo, std::size_t hi) {
+        stl::fill(first + lo, first + hi, value);
+    });
+}
+template<typename Policy, typename ForwardIterator, typename T>
+inline void __par_fill(const Policy&, ForwardIterator first, ForwardIterator last,
+                       const T& value, forward_iterator_tag) {
+    stl::fill(first, last, value);
+}
+
+template<typename Policy, typename RandomAccessIterator, typename Predicate>
+typename iterator_traits<RandomAccessIterator>::difference_type
+__par_count_if(const Policy& policy, RandomAccessIterator first, RandomAccessIterator last,
+               Predicate pred, random_access_iterator_tag) {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    std::atomic<Distance> total(0);
+    __parallel_blocks(policy, last - first, [&](std::size_t lo, std::size_t hi) {
+        total.fetch_add(stl::count_if(first + lo, first + hi, pred), std::memory_order_relaxed);
+    });
+    return total.load();
+}
+template<typename Policy, typename InputIterator, typename Predicate>
+inline typename iterator_traits<InputIterator>::difference_type
+__par_count_if(const Policy&, InputIterator first, InputIterator last,
+               Predicate pred, input_iterator_tag) {
+    return stl::count_if(first, last, pred);
+}
+
+// Blocks past the best match so far are skipped, and a block gives up
+// every __find_if_stride elements once an earlier match has been found.
+enum { __find_if_stride = 1024 };
+
+template<typename Policy, typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator __par_find_if(const Policy& policy, RandomAccessIterator first,
+                                   RandomAccessIterator last, Predicate pred,
+                                   random_access_iterator_tag) {
+    std::size_t n = last - first;
+    std::atomic<std::size_t> best(n);
+    __parallel_blocks(policy, n, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t i = lo; i < hi; i += __find_if_stride) {
+            if (best.load(std::memory_order_relaxed) <= i)
+                return;
+            std::size_t end = hi - i > std::size_t(__find_if_stride) ? i + __find_if_stride : hi;
+            RandomAccessIterator hit = stl::find_if(first + i, first + end, pred);
+            if (hit != first + end) {
+                std::size_t pos = hit - first;
+                std::size_t cur = best.load(std::memory_order_relaxed);
+                while (pos < cur && !best.compare_exchange_weak(cur, pos)) { }
+                return;
+            }
+        }
+    });
+    return first + best.load();
+}
+template<typename Policy, typename InputIterator, typename Predicate>
+inline InputIterator __par_find_if(const Policy&, InputIterator first, InputIterator last,
+                                   Predicate pred, input_iterator_tag) {
+    return stl::find_if(first, last, pred);
+}
+
+template<typename Policy, typename RandomAccessIterator, typename T, typename BinaryOperation>
+T __par_reduce(const Policy& policy, RandomAccessIterator first, RandomAccessIterator last,
+               T init, BinaryOperation binary_op, random_access_iterator_tag) {
+    // every block folds its own elements, the partial results are then
+    // folded into init in whatever order the blocks finish
+    std::mutex m;
+    __parallel_blocks(policy, last - first, [&](std::size_t lo, std::size_t hi) {
+        T partial = *(first + lo);
+        for (RandomAccessIterator cur = first + lo + 1; cur != first + hi; ++cur)
+            partial = binary_op(partial, *cur);
+        std::lock_guard<std::mutex> lock(m);
+        init = binary_op(init, partial);
+    });
+    return init;
+}
+template<typename Policy, typename InputIterator, typename T, typename BinaryOperation>
+inline T __par_reduce(const Policy&, InputIterator first, InputIterator last,
+                      T init, BinaryOperation binary_op, input_iterator_tag) {
+    return stl::reduce(first, last, init, binary_op);
+}
+
+
+// for_each
+template<typename ExecutionPolicy, typename ForwardIterator, typename Function>
+inline __enable_if_execution_policy<ExecutionPolicy, void>
+for_each(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, Function f) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value)
+        stl::for_each(first, last, f);
+    else
+        __par_for_each(policy, first, last, f, stl::iterator_category(first));
+}
+
+// fill
+template<typename ExecutionPolicy, typename ForwardIterator, typename T>
+inline __enable_if_execution_policy<ExecutionPolicy, void>
+fill(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, const T& value) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value)
+        stl::fill(first, last, value);
+    else
+        __par_fill(policy, first, last, value, stl::iterator_category(first));
+}
+
+// count_if
+template<typename ExecutionPolicy, typename ForwardIterator, typename Predicate>
+inline __enable_if_execution_policy<ExecutionPolicy,
+                                    typename iterator_traits<ForwardIterator>::difference_type>
+count_if(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, Predicate pred) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value)
+        return stl::count_if(first, last, pred);
+    else
+        return __par_count_if(policy, first, last, pred, stl::iterator_category(first));
+}
+
+// find_if
+template<typename ExecutionPolicy, typename ForwardIterator, typename Predicate>
+inline __enable_if_execution_policy<ExecutionPolicy, ForwardIterator>
+find_if(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, Predicate pred) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value)
+        return stl::find_if(first, last, pred);
+    else
+        return __par_find_if(policy, first, last, pred, stl::iterator_category(first));
+}
+
+// copy
+// Pointers to one trivially copyable type are copied as bytes: the blocks go
+// to the copy engine, streaming or not as the whole copy's size says.
+template<typename ForwardIterator1, typename ForwardIterator2>
+struct __par_copy_bytes {
+    typedef typename std::remove_cv<typename std::remove_pointer<ForwardIterator1>::type>::type T;
+    enum { value = std::is_pointer<ForwardIterator1>::value
+                   && std::is_same<ForwardIterator2, T*>::value
+                   && std::is_trivially_copyable<T>::value };
+};
+
+template<typename ExecutionPolicy, typename ForwardIterator1, typename ForwardIterator2>
+__enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>
+copy(ExecutionPolicy&& policy, ForwardIterator1 first, ForwardIterator1 last,
+     ForwardIterator2 result) {
+    if constexpr (!std::is_same<typename std::decay<ExecutionPolicy>::type,
+                                execution::sequenced_policy>::value) {
+        if constexpr (__par_copy_bytes<ForwardIterator1, ForwardIterator2>::value) {
+            typedef typename __par_copy_bytes<ForwardIterator1, ForwardIterator2>::T T;
+            std::size_t n = last - first;
+            bool stream = n * sizeof(T) >= __simd_stream_threshold();
+            __parallel_blocks(policy, n, [&](std::size_t lo, std::size_t hi) {
+                __copy_bytes(result + lo, first + lo, (hi - lo) * sizeof(T), stream);
+            });
+            return result + n;
+        }
+        if (__all_random_access(stl::iterator_category(first), stl::iterator_category(result))) {
+            std::size_t n = stl::distance(first, last);
+            __parallel_blocks(policy, n, [&](std::size_t lo, std::size_t hi) {
+                ForwardIterator1 from = first;
+                ForwardIterator2 to = result;
+                stl::advance(from, lo);
+                stl::advance(to, lo);
+                ForwardIterator1 end = from;
+                stl::advance(end, hi - lo);
+                stl::copy(from, end, to);
+            });
+            stl::advance(result, n);
+            return result;
+        }
+    }
+    return stl::copy(first, last, result);
+}
+
+// transform
+template<typename ExecutionPolicy, typename ForwardIterator1, typename ForwardIterator2,
+         typename UnaryOperation>
+__enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>
+transform(ExecutionPolicy&& policy, ForwardIterator1 first, ForwardIterator1 last,
+          ForwardIterator2 result, UnaryOperation op) {
+    if constexpr (!std::is_same<typename std::decay<ExecutionPolicy>::type,
+                                execution::sequenced_policy>::value) {
+        if (__all_random_access(stl::iterator_category(first), stl::iterator_category(result))) {
+            std::size_t n = stl::distance(first, last);
+            __parallel_blocks(policy, n, [&](std::size_t lo, std::size_t hi) {
+                ForwardIterator1 from = first;
+                ForwardIterator2 to = result;
+                stl::advance(from, lo);
+                stl::advance(to, lo);
+                for (std::size_t i = lo; i < hi; ++i, ++from, ++to)
+                    *to = op(*from);
+            });
+            stl::advance(result, n);
+            return result;
+        }
+    }
+    return stl::transform(first, last, result, op);
+}
+
+template<typename ExecutionPolicy, typename ForwardIterator1, typename ForwardIterator2,
+         typename ForwardIterator3, typename BinaryOperation>
+__enable_if_execution_policy<ExecutionPolicy, ForwardIterator3>
+transform(ExecutionPolicy&& policy, ForwardIterator1 first1, ForwardIterator1 last1,
+          ForwardIterator2 first2, ForwardIterator3 result, BinaryOperation binary_op) {
+    if constexpr (!std::is_same<typename std::decay<ExecutionPolicy>::type,
+                                execution::sequenced_policy>::value) {
+        if (__all_random_access(stl::iterator_category(first1), stl::iterator_category(first2),
+                                stl::iterator_category(result))) {
+            std::size_t n = stl::distance(first1, last1);
+            __parallel_blocks(policy, n, [&](std::size_t lo, std::size_t hi) {
+                ForwardIterator1 from1 = first1;
+                ForwardIterator2 from2 = first2;
+                ForwardIterator3 to = result;
+                stl::advance(from1, lo);
+                stl::advance(from2, lo);
+                stl::advance(to, lo);
+                for (std::size_t i = lo; i < hi; ++i, ++from1, ++from2, ++to)
+                    *to = binary_op(*from1, *from2);
+            });
+            stl::advance(result, n);
+            return result;
+        }
+    }
+    return stl::transform(first1, last1, first2, result, binary_op);
+}
+
+// reduce: like accumulate, but binary_op must be associative and
+// commutative so that the blocks may be folded in any order.
+template<typename ExecutionPolicy, typename ForwardIterator, typename T, typename BinaryOperation>
+inline __enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last,
+       T init, BinaryOperation binary_op) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value)
+        return stl::reduce(first, last, init, binary_op);
+    else
+        return __par_reduce(policy, first, last, init, binary_op, stl::iterator_category(first));
+}
+
+template<typename ExecutionPolicy, typename ForwardIterator, typename T>
+inline __enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, T init) {
+    return stl::reduce(policy, first, last, init, stl::plus<T>());
+}
+
+template<typename ExecutionPolicy, typename ForwardIterator>
+inline __enable_if_execution_policy<ExecutionPolicy,
+                                    typename iterator_traits<ForwardIterator>::value_type>
+reduce(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last) {
+    typedef typename iterator_traits<ForwardIterator>::value_type T;
+    return stl::reduce(policy, first, last, T(), stl::plus<T>());
+}
+
+// sort
+// Parallel introsort: the top levels partition in parallel, the two sides
+// of every partition are sorted as independent tasks, and ranges below
+// __par_sort_cutoff finish with the sequential pdqsort engine.  Both stages
+// fall back to heapsort when they run out of good pivots, which bounds the
+// worst case.
+enum { __par_sort_cutoff = 1 << 14 };           // sort sequentially below this
+enum { __par_partition_threshold = 1 << 17 };   // partition in parallel above this
+enum { __par_partition_max_chunks = 64 };
+
+// Block-parallel partition by pred: every chunk is partitioned on its own,
+// then the elements on the wrong side of the final split point are
+// exchanged pairwise, also in parallel.
+template<typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator __par_partition(thread_pool& pool, RandomAccessIterator first,
+                                     RandomAccessIterator last, Predicate pred) {
+    typedef std::ptrdiff_t Distance;
+    Distance n = last - first;
+    Distance chunks = Distance(pool.concurrency()) * 4;
+    if (chunks > __par_partition_max_chunks)
+        chunks = __par_partition_max_chunks;
+    if (chunks > n / (__par_sort_cutoff / 4))
+        chunks = n / (__par_sort_cutoff / 4);
+    if (chunks < 2)
+        return stl::partition(first, last, pred);
+
+    Distance begin[__par_partition_max_chunks + 1], mid[__par_partition_max_chunks];
+    for (Distance c = 0; c <= chunks; ++c)
+        begin[c] = n * c / chunks;
+    pool.parallel_for(chunks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; ++c)
+            mid[c] = stl::partition(first + begin[c], first + begin[c + 1], pred) - first;
+    });
+
+    Distance split = 0;
+    for (Distance c = 0; c < chunks; ++c)
+        split += mid[c] - begin[c];
+
+    // misplaced: big elements left of split and small ones right of it,
+    // as intervals with running offsets
+    Distance big_lo[__par_partition_max_chunks], big_hi[__par_partition_max_chunks];
+    Distance small_lo[__par_partition_max_chunks], small_hi[__par_partition_max_chunks];
+    Distance big_off[__par_partition_max_chunks + 1], small_off[__par_partition_max_chunks + 1];
+    Distance nbig = 0, nsmall = 0;
+    big_off[0] = small_off[0] = 0;
+    for (Distance c = 0; c < chunks; ++c) {
+        Distance hi = begin[c + 1] < split ? begin[c + 1] : split;
+        if (mid[c] < hi) {
+            big_lo[nbig] = mid[c];
+            big_hi[nbig] = hi;
+            big_off[nbig + 1] = big_off[nbig] + (hi - mid[c]);
+            ++nbig;
+        }
+        Distance lo = begin[c] > split ? begin[c] : split;
+        if (lo < mid[c]) {
+            small_lo[nsmall] = lo;
+            small_hi[nsmall] = mid[c];
+            small_off[nsmall + 1] = small_off[nsmall] + (mid[c] - lo);
+            ++nsmall;
+        }
+    }
+    Distance misplaced = big_off[nbig];
+    if (misplaced > 0) {
+        pool.parallel_for(misplaced, __par_sort_cutoff, [&](std::size_t lo, std::size_t hi) {
+            Distance k = Distance(lo);
+            Distance b = 0, s = 0;
+            while (big_off[b + 1] <= k) ++b;
+            while (small_off[s + 1] <= k) ++s;
+            RandomAccessIterator x = first + big_lo[b] + (k - big_off[b]);
+            RandomAccessIterator y = first + small_lo[s] + (k - small_off[s]);
+            for (; k < Distance(hi); ++k) {
+                if (x == first + big_hi[b])
+                    x = first + big_lo[++b];
+                if (y == first + small_hi[s])
+                    y = first + small_lo[++s];
+                stl::iter_swap(x, y);
+                ++x;
+                ++y;
+            }
+        });
+    }
+    return first + split;
+}
+
+template<typename RandomAccessIterator, typename T, typename Size, typename Compare>
+void __par_introsort_loop(thread_pool& pool, RandomAccessIterator first,
+                          RandomAccessIterator last, T*, Size depth_limit, Compare comp) {
+    while (last - first > __par_sort_cutoff) {
+        if (depth_limit == 0) {
+            stl::partial_sort(first, last, last, comp);
+            return;
+        }
+        --depth_limit;
+        T pivot = T(stl::__median(*first, *(first + (last - first) / 2), *(last - 1), comp));
+        RandomAccessIterator cut;
+        if (last - first > __par_partition_threshold) {
+            cut = __par_partition(pool, first, last,
+                                  [&pivot, comp](const T& x) { return comp(x, pivot); });
+            if (cut == first) {
+                // nothing is below the pivot: peel off the elements equal to it
+                first = __par_partition(pool, first, last,
+                                        [&pivot, comp](const T& x) { return !comp(pivot, x); });
+                continue;
+            }
+        } else {
+            cut = stl::__unguarded_partition(first, last, pivot, comp);
+        }
+        RandomAccessIterator lo = first;
+        pool.fork_join(
+            [&] { __par_introsort_loop(pool, cut, last, (T*)0, depth_limit, comp); },
+            [&] { __par_introsort_loop(pool, lo, cut, (T*)0, depth_limit, comp); });
+        return;
+    }
+    stl::__pdqsort(first, last, comp);
+}
+
+template<typename ExecutionPolicy, typename RandomAccessIterator, typename Compare>
+inline __enable_if_execution_policy<ExecutionPolicy, void>
+sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last,
+     Compare comp) {
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value) {
+        stl::sort(first, last, comp);
+    } else {
+        thread_pool& pool = __policy_pool(policy);
+        if (pool.workers() == 0 || last - first <= __par_sort_cutoff) {
+            stl::sort(first, last, comp);
+            return;
+        }
+        __par_introsort_loop(pool, first, last, value_type(first),
+                             stl::__lg(last - first) * 2, comp);
+    }
+}
+
+template<typename ExecutionPolicy, typename RandomAccessIterator>
+inline __enable_if_execution_policy<ExecutionPolicy, void>
+sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if constexpr (std::is_same<typename std::decay<ExecutionPolicy>::type,
+                               execution::sequenced_policy>::value) {
+        stl::sort(first, last);
+    } else {
+        thread_pool& pool = __policy_pool(policy);
+        if (pool.workers() == 0 || last - first <= __par_sort_cutoff) {
+            stl::sort(first, last);
+            return;
+        }
+        __par_introsort_loop(pool, first, last, value_type(first),
+                             stl::__lg(last - first) * 2, stl::less<T>());
+    }
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_EXECUTION_ */
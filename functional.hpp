@@ -177,6 +177,8 @@ public:
     operator()(const typename Operation::second_argument_type& x) const {
         return op(value, x);
     }
+    // the bound operand, for algorithms that special-case binders
+    const typename Operation::first_argument_type& bound_argument() const { return value; }
 };
 
 template<typename Operation, typename T>
@@ -197,8 +199,9 @@ public:
      : op(x), value(y) { }
     typename Operation::result_type
     operator()(const typename Operation::first_argument_type& x) const {
-        return op(value, x);
+        return op(x, value);
     }
+    const typename Operation::second_argument_type& bound_argument() const { return value; }
 };
 
 template<typename Operation, typename T>
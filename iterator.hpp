@@ -3,6 +3,8 @@
 
 #include <cstddef>
 #include <iostream>
+#include <iterator>
+#include "__type_traits.hpp"
 
 namespace stl {
 
@@ -22,9 +24,23 @@ struct iterator {
     typedef Reference   reference;
 };
 
+// std's tags map onto ours, so std iterators dispatch like stl ones
+template<typename Category>
+struct __iterator_tag { typedef Category type; };
+template<>
+struct __iterator_tag<std::input_iterator_tag> { typedef input_iterator_tag type; };
+template<>
+struct __iterator_tag<std::output_iterator_tag> { typedef output_iterator_tag type; };
+template<>
+struct __iterator_tag<std::forward_iterator_tag> { typedef forward_iterator_tag type; };
+template<>
+struct __iterator_tag<std::bidirectional_iterator_tag> { typedef bidirectional_iterator_tag type; };
+template<>
+struct __iterator_tag<std::random_access_iterator_tag> { typedef random_access_iterator_tag type; };
+
 template<typename Iterator>
 struct iterator_traits {
-    typedef typename Iterator::iterator_category  iterator_category;
+    typedef typename __iterator_tag<typename Iterator::iterator_category>::type iterator_category;
     typedef typename Iterator::value_type         value_type;
     typedef typename Iterator::difference_type    difference_type;
     typedef typename Iterator::pointer            pointer;
@@ -52,6 +68,17 @@ struct iterator_traits<const T*> {
     typedef T&                           reference;
 };
 
+// Segmented iterators walk a sequence of contiguous buffers (e.g. deque).
+// Specializations describe the two levels so that algorithms can loop over
+// each buffer with a plain pointer instead of paying the per-step boundary
+// check.  A specialization provides:
+//   segment_iterator, local_iterator
+//   segment(it), local(it), begin(seg), end(seg), compose(seg, local)
+template<typename Iterator>
+struct __segmented_iterator_traits {
+    typedef __traits::__false_type is_segmented_iterator;
+};
+
 template<typename Iterator>
 inline typename iterator_traits<Iterator>::iterator_category
 iterator_category(const Iterator&) {
@@ -310,6 +337,16 @@ public:
         read();
         return tmp;
     }
+
+    // Two iterators are equal if both are at end of stream, or both read
+    // from the same stream.
+    bool operator==(const istream_iterator<T, Distance>& x) const {
+        return (stream == x.stream && end_marker == x.end_marker)
+            || (!end_marker && !x.end_marker);
+    }
+    bool operator!=(const istream_iterator<T, Distance>& x) const {
+        return !(*this == x);
+    }
 };
 
 template<typename T>
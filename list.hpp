@@ -42,7 +42,7 @@ struct __list_iterator {
         node = (link_type)(node->next);
         return *this;
     }
-    self& operator++(int) {
+    self operator++(int) {
         self tmp = *this;
         ++*this;
         return tmp;
@@ -51,7 +51,7 @@ struct __list_iterator {
         node = (link_type)(node->prev);
         return *this;
     }
-    self& operator--(int) {
+    self operator--(int) {
         self tmp = *this;
         --*this;
         return tmp;
@@ -11,6 +11,7 @@
 
 #include "./utils.hpp"
 #include <cstdlib>
+#include <mutex>
 
 namespace stl::memory {
 
@@ -116,6 +117,14 @@ private:
     static char *end_free;
     static size_t heap_size;
 
+    // threads == true: one lock serialises the free lists and the chunk
+    static std::mutex pool_mutex;
+    class lock {
+    public:
+        lock() { if (threads) pool_mutex.lock(); }
+        ~lock() { if (threads) pool_mutex.unlock(); }
+    };
+
 public:
     static void *allocate(size_t n)
     {
@@ -126,6 +135,7 @@ public:
             return malloc_alloc::allocate(n);
         }
 
+        lock lock_instance;
         my_free_list = free_list + FREELIST_INDEX(n);
         result = *my_free_list;
         if (0 == result) {
@@ -147,6 +157,7 @@ public:
             return ;
         }
 
+        lock lock_instance;
         my_free_list = free_list + FREELIST_INDEX(n);
         q->free_list_link = *my_free_list;
         *my_free_list = q;
@@ -164,6 +175,9 @@ char *__default_alloc_template<threads, inst>::end_free = 0;
 template<bool threads, int inst>
 size_t __default_alloc_template<threads, inst>::heap_size = 0;
 
+template<bool threads, int inst>
+std::mutex __default_alloc_template<threads, inst>::pool_mutex;
+
 template<bool threads, int inst>
 typename __default_alloc_template<threads, inst>::obj * volatile
 __default_alloc_template<threads, inst>::free_list[__NFREELISTS] = 
@@ -249,11 +263,14 @@ chunk_alloc(size_t size, int& nobjs)
 }
 
 
+// threaded_alloc: for nodes allocated and freed by several threads
 #ifdef __USE_MALLOC
 typedef malloc_alloc alloc;
+typedef malloc_alloc threaded_alloc;
 #else
 #define __NODE_ALLOCATOR_THREADS 0
 typedef __default_alloc_template<__NODE_ALLOCATOR_THREADS, 0> alloc;
+typedef __default_alloc_template<true, 0> threaded_alloc;
 #endif
 
 template<typename T, class Alloc>
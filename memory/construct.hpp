@@ -2,6 +2,7 @@
 #define STL_IMPL_MEMORY_CONSTRUCT_
 
 #include <new>  // for placement new
+#include <utility>
 #include "../__type_traits.hpp"
 using namespace stl::__traits;
 #include "../iterator.hpp"
@@ -13,6 +14,11 @@ inline void construct(T1 *p, const T2 &value) {
     new (p) T1(value);
 }
 
+template<typename T, typename... Args>
+inline void construct(T *p, Args&&... args) {
+    new (p) T(std::forward<Args>(args)...);
+}
+
 template<typename T>
 inline void destroy(T *pointer) {
     pointer->~T();
@@ -7,13 +7,14 @@
 using namespace stl::__traits;
 #include "./construct.hpp"
 #include "../iterator.hpp"
+#include "../algobase.hpp"
 
 namespace stl::memory {
 
 template<typename ForwardIterator, typename Size, typename T>
 inline ForwardIterator
 __uninitialized_fill_n_aux(ForwardIterator first, Size n, const T& x, __true_type) {
-    return std::fill_n(first, n, x);
+    return stl::fill_n(first, n, x);
 }
 
 template<typename ForwardIterator, typename Size, typename T>
@@ -43,7 +44,7 @@ template<typename InputIterator, typename ForwardIterator>
 inline ForwardIterator
 __uninitialized_copy_aux(InputIterator first, InputIterator last, 
                            ForwardIterator result, __true_type) {
-    return std::copy(first, last, result);
+    return stl::copy(first, last, result);
 }
 
 template<typename InputIterator, typename ForwardIterator>
@@ -73,20 +74,20 @@ uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator resu
 
 inline char *uninitialized_copy(const char *first, const char *last, char *result)
 {
-    memmove(result, first, sizeof(char) * (last - first));
+    stl::__copy_bytes(result, first, sizeof(char) * (last - first));
     return result + (last - first);
 }
 
 inline wchar_t *uninitialized_copy(const wchar_t *first, const wchar_t *last, wchar_t *result)
 {
-    memmove(result, first, sizeof(wchar_t) * (last - first));
+    stl::__copy_bytes(result, first, sizeof(wchar_t) * (last - first));
     return result + (last - first);
 }
 
 template<typename ForwardIterator, typename T>
 inline void
 __uninitialized_fill_aux(ForwardIterator first, ForwardIterator last, const T& x, __true_type) {
-    std::fill(first, last, x);
+    stl::fill(first, last, x);
 }
 
 template<typename ForwardIterator, typename T>
@@ -0,0 +1,333 @@
+#ifndef STL_IMPL_MPMC_QUEUE_
+#define STL_IMPL_MPMC_QUEUE_
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "memory/alloc.hpp"
+#include "iterator.hpp"
+#include "ring_buffer.hpp"
+#include "__concurrency.hpp"
+
+namespace stl {
+
+using namespace memory;
+
+// Bounded multi-producer/multi-consumer queue (Vyukov).
+// Every cell carries a sequence number: a cell at position pos is free for
+// the producer of pos when seq == pos, and holds the element for the
+// consumer of pos when seq == pos + 1; the consumer hands it on to the
+// producer of pos + capacity by storing seq = pos + capacity.  A producer
+// (consumer) claims its position with one CAS on enqueue_pos (dequeue_pos),
+// so the queue is lock-free and producers and consumers only contend among
+// themselves.  The batch forms claim a whole run of ready cells with a
+// single CAS.
+//
+// With Blocking == true push() and pop() sleep on a condition variable
+// instead of spinning when the queue is full/empty; the non-blocking paths
+// pay for that only when some thread is actually asleep.
+//
+// Claimed cells must be published, so elements are built before a cell is
+// claimed and then moved in: T's move constructor must not throw.  Popped
+// elements are moved out and the cell released before they are assigned;
+// if a batch try_pop's assignment throws, its remaining elements are lost.
+template<typename T, typename Alloc = alloc, bool Blocking = false>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "mpmc_queue requires a non-throwing move constructor");
+public:
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef std::size_t size_type;
+
+protected:
+    struct cell {
+        std::atomic<size_type> seq;
+        alignas(value_type) unsigned char storage[sizeof(value_type)];
+        value_type* data() { return reinterpret_cast<value_type*>(storage); }
+    };
+    typedef simple_alloc<cell, Alloc> cell_allocator;
+
+    cell* cells;
+    size_type mask;
+
+    alignas(__cache_line_size) std::atomic<size_type> enqueue_pos;
+    alignas(__cache_line_size) std::atomic<size_type> dequeue_pos;
+
+    // sleepers, used only when Blocking
+    alignas(__cache_line_size) std::atomic<int> pop_waiters;
+    std::atomic<int> push_waiters;
+    std::mutex wait_mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    cell* cell_at(size_type pos) const { return cells + (pos & mask); }
+    static std::ptrdiff_t diff(size_type a, size_type b) { return std::ptrdiff_t(a - b); }
+
+public:
+    explicit mpmc_queue(size_type capacity = 1024)
+     : cells(0), mask(__ring_buffer_capacity(capacity < 2 ? 2 : capacity) - 1),
+       enqueue_pos(0), dequeue_pos(0), pop_waiters(0), push_waiters(0)
+    {
+        cells = cell_allocator::allocate(mask + 1);
+        for (size_type i = 0; i <= mask; ++i)
+            new (&cells[i].seq) std::atomic<size_type>(i);
+    }
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+    ~mpmc_queue() {
+        size_type e = enqueue_pos.load(std::memory_order_relaxed);
+        for (size_type pos = dequeue_pos.load(std::memory_order_relaxed); pos != e; ++pos)
+            memory::destroy(cell_at(pos)->data());
+        cell_allocator::deallocate(cells, mask + 1);
+    }
+
+public:
+    size_type capacity() const { return mask + 1; }
+    // A snapshot; exact only while no other thread is using the queue.
+    size_type size() const {
+        size_type d = dequeue_pos.load(std::memory_order_acquire);
+        size_type e = enqueue_pos.load(std::memory_order_acquire);
+        return diff(e, d) > 0 ? e - d : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+public:
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        value_type tmp(std::forward<Args>(args)...);
+        return try_push(std::move(tmp));
+    }
+    bool try_push(const value_type& x) {
+        value_type tmp(x);
+        return try_push(std::move(tmp));
+    }
+    bool try_push(value_type&& x) {
+        if (!push_one(x))
+            return false;
+        wake(pop_waiters, not_empty);
+        return true;
+    }
+    bool try_pop(value_type& x) {
+        if (!pop_one(x))
+            return false;
+        wake(push_waiters, not_full);
+        return true;
+    }
+
+    // Push as many elements of [first, last) as there are free cells,
+    // claiming them with one CAS.  Returns the first element not pushed.
+    template<typename ForwardIterator>
+    ForwardIterator try_push(ForwardIterator first, ForwardIterator last);
+    // Pop up to n elements into out, claiming them with one CAS.
+    // Returns how many were popped.
+    template<typename OutputIterator>
+    size_type try_pop(OutputIterator out, size_type n);
+
+    // Wait while the queue is full / empty: spin, then yield, or sleep when
+    // Blocking.
+    void push(const value_type& x) {
+        value_type tmp(x);
+        push(std::move(tmp));
+    }
+    void push(value_type&& x);
+    void pop(value_type& x);
+
+protected:
+    bool claim_push(size_type& pos, size_type n, size_type& claimed);
+    bool claim_pop(size_type& pos, size_type n, size_type& claimed);
+    // try_push / try_pop without waking sleepers
+    bool push_one(value_type& x);
+    bool pop_one(value_type& x);
+    void wake(std::atomic<int>& waiters, std::condition_variable& cv) {
+        if (!Blocking)
+            return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            { std::lock_guard<std::mutex> lock(wait_mutex); }
+            cv.notify_all();
+        }
+    }
+};
+
+// Claim up to n consecutive positions starting at the current one whose
+// cells are ready.  Returns false when the first cell is not.
+template<typename T, typename Alloc, bool Blocking>
+bool mpmc_queue<T, Alloc, Blocking>::claim_push(size_type& pos, size_type n, size_type& claimed)
+{
+    pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        std::ptrdiff_t d = diff(cell_at(pos)->seq.load(std::memory_order_acquire), pos);
+        if (d < 0)
+            return false;       // full
+        if (d > 0) {            // another producer got there first
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+            continue;
+        }
+        size_type k = 1;
+        while (k < n && cell_at(pos + k)->seq.load(std::memory_order_acquire) == pos + k)
+            ++k;
+        if (enqueue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+            claimed = k;
+            return true;
+        }
+    }
+}
+
+template<typename T, typename Alloc, bool Blocking>
+bool mpmc_queue<T, Alloc, Blocking>::claim_pop(size_type& pos, size_type n, size_type& claimed)
+{
+    pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        std::ptrdiff_t d = diff(cell_at(pos)->seq.load(std::memory_order_acquire), pos + 1);
+        if (d < 0)
+            return false;       // empty
+        if (d > 0) {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+            continue;
+        }
+        size_type k = 1;
+        while (k < n && cell_at(pos + k)->seq.load(std::memory_order_acquire) == pos + k + 1)
+            ++k;
+        if (dequeue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+            claimed = k;
+            return true;
+        }
+    }
+}
+
+template<typename T, typename Alloc, bool Blocking>
+bool mpmc_queue<T, Alloc, Blocking>::push_one(value_type& x)
+{
+    size_type pos, k;
+    if (!claim_push(pos, 1, k))
+        return false;
+    cell* c = cell_at(pos);
+    construct(c->data(), std::move(x));
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename Alloc, bool Blocking>
+bool mpmc_queue<T, Alloc, Blocking>::pop_one(value_type& x)
+{
+    size_type pos, k;
+    if (!claim_pop(pos, 1, k))
+        return false;
+    // release the cell before the assignment, which may throw
+    cell* c = cell_at(pos);
+    value_type tmp(std::move(*c->data()));
+    memory::destroy(c->data());
+    c->seq.store(pos + capacity(), std::memory_order_release);
+    x = std::move(tmp);
+    return true;
+}
+
+template<typename T, typename Alloc, bool Blocking>
+template<typename ForwardIterator>
+ForwardIterator mpmc_queue<T, Alloc, Blocking>::try_push(ForwardIterator first, ForwardIterator last)
+{
+    if (!std::is_nothrow_copy_constructible<value_type>::value) {
+        // a throwing copy must not happen inside a claimed cell
+        for (; first != last && try_push(*first); ++first) { }
+        return first;
+    }
+    size_type n = stl::distance(first, last);
+    size_type pos, k;
+    if (n == 0 || !claim_push(pos, n, k))
+        return first;
+    for (size_type i = 0; i < k; ++i, ++first) {
+        cell* c = cell_at(pos + i);
+        construct(c->data(), *first);
+        c->seq.store(pos + i + 1, std::memory_order_release);
+    }
+    wake(pop_waiters, not_empty);
+    return first;
+}
+
+template<typename T, typename Alloc, bool Blocking>
+template<typename OutputIterator>
+typename mpmc_queue<T, Alloc, Blocking>::size_type
+mpmc_queue<T, Alloc, Blocking>::try_pop(OutputIterator out, size_type n)
+{
+    size_type pos, k;
+    if (n == 0 || !claim_pop(pos, n, k))
+        return 0;
+    size_type i = 0;
+    try {
+        for (; i < k; ++i, ++out) {
+            cell* c = cell_at(pos + i);
+            value_type tmp(std::move(*c->data()));
+            memory::destroy(c->data());
+            c->seq.store(pos + i + capacity(), std::memory_order_release);
+            *out = std::move(tmp);
+        }
+    }
+    catch (...) {
+        // the rest of the claimed cells are dropped, not left claimed
+        while (++i < k) {
+            cell* c = cell_at(pos + i);
+            memory::destroy(c->data());
+            c->seq.store(pos + i + capacity(), std::memory_order_release);
+        }
+        wake(push_waiters, not_full);
+        throw;
+    }
+    wake(push_waiters, not_full);
+    return k;
+}
+
+template<typename T, typename Alloc, bool Blocking>
+void mpmc_queue<T, Alloc, Blocking>::push(value_type&& x)
+{
+    __backoff wait;
+    for (int spin = 0; spin < 64; ++spin, wait())
+        if (try_push(std::move(x)))
+            return;
+    if (!Blocking) {
+        while (!try_push(std::move(x)))
+            wait();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        push_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!push_one(x))
+            not_full.wait(lock);
+        push_waiters.fetch_sub(1);
+    }
+    wake(pop_waiters, not_empty);
+}
+
+template<typename T, typename Alloc, bool Blocking>
+void mpmc_queue<T, Alloc, Blocking>::pop(value_type& x)
+{
+    __backoff wait;
+    for (int spin = 0; spin < 64; ++spin, wait())
+        if (try_pop(x))
+            return;
+    if (!Blocking) {
+        while (!try_pop(x))
+            wait();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        pop_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!pop_one(x))
+            not_empty.wait(lock);
+        pop_waiters.fetch_sub(1);
+    }
+    wake(push_waiters, not_full);
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_MPMC_QUEUE_ */
@@ -6,19 +6,64 @@
 
 namespace stl {
 // Accumulate
-template<typename InputIterator, typename T>
-T accumulate(InputIterator first, InputIterator last, T init) {
+template<typename InputIterator, typename T, typename BinaryOperation>
+inline T __accumulate(InputIterator first, InputIterator last, T init,
+                      BinaryOperation binary_op, __traits::__false_type) {
     for ( ; first != last; ++first)
-        init = init + *first;
+        init = binary_op(init, *first);
     return init;
 }
 
+template<typename SegmentedIterator, typename T, typename BinaryOperation>
+T __accumulate(SegmentedIterator first, SegmentedIterator last, T init,
+               BinaryOperation binary_op, __traits::__true_type) {
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast)
+        return __accumulate(traits::local(first), traits::local(last), init,
+                            binary_op, __traits::__false_type());
+    init = __accumulate(traits::local(first), traits::end(sfirst), init,
+                        binary_op, __traits::__false_type());
+    for (++sfirst; sfirst != slast; ++sfirst)
+        init = __accumulate(traits::begin(sfirst), traits::end(sfirst), init,
+                            binary_op, __traits::__false_type());
+    return __accumulate(traits::begin(slast), traits::local(last), init,
+                        binary_op, __traits::__false_type());
+}
+
+template<typename InputIterator, typename T>
+inline T accumulate(InputIterator first, InputIterator last, T init) {
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+    return __accumulate(first, last, init,
+                        [](const T& x, const auto& y) -> T { return x + y; }, segmented());
+}
+
 template<typename InputIterator, typename T, typename BinaryOperation>
-T accumulate(InputIterator first, InputIterator last, T init, 
-             BinaryOperation binary_op) {
-    for ( ; first != last; ++first)
-        init = binary_op(init, *first);
-    return init;
+inline T accumulate(InputIterator first, InputIterator last, T init, 
+                    BinaryOperation binary_op) {
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+    return __accumulate(first, last, init, binary_op, segmented());
+}
+
+// Reduce
+// The sequential reduce is accumulate; the overloads taking an execution
+// policy (execution.hpp) may fold in any order.
+template<typename InputIterator, typename T, typename BinaryOperation>
+inline T reduce(InputIterator first, InputIterator last, T init, BinaryOperation binary_op) {
+    return stl::accumulate(first, last, init, binary_op);
+}
+
+template<typename InputIterator, typename T>
+inline T reduce(InputIterator first, InputIterator last, T init) {
+    return stl::accumulate(first, last, init);
+}
+
+template<typename InputIterator>
+inline typename iterator_traits<InputIterator>::value_type
+reduce(InputIterator first, InputIterator last) {
+    typedef typename iterator_traits<InputIterator>::value_type T;
+    return stl::accumulate(first, last, T());
 }
 
 
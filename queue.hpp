@@ -2,6 +2,7 @@
 #define STL_IMPL_QUEUE_
 
 #include "deque.hpp"
+#include <utility>
 
 namespace stl
 {
@@ -10,6 +11,8 @@ template<typename T, typename Sequence = stl::deque<T>>
 class queue {
 public:
     queue() = default;
+    explicit queue(const Sequence& s) : c(s) { }
+    explicit queue(Sequence&& s) : c(std::move(s)) { }
 
 public:
     typedef typename Sequence::value_type       value_type;
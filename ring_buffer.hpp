@@ -0,0 +1,296 @@
+#ifndef STL_IMPL_RING_BUFFER_
+#define STL_IMPL_RING_BUFFER_
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include "memory/alloc.hpp"
+#include "iterator.hpp"
+#include "utility.hpp"
+
+namespace stl {
+
+using namespace memory;
+
+// Fixed-capacity circular buffer.
+// The capacity is rounded up to a power of two, so an element index is a
+// mask away from its slot.  head and tail are free-running counters
+// (size == tail - head); unsigned wrap-around keeps that exact.
+// With Overwrite == false pushing into a full buffer throws
+// std::length_error; with Overwrite == true it drops the element at the
+// opposite end.
+
+// n rounded up to a power of two; std::length_error past the largest one
+inline std::size_t __ring_buffer_capacity(std::size_t n)
+{
+    const std::size_t max_cap = ~(std::size_t(-1) >> 1);
+    if (n > max_cap)
+        throw std::length_error("ring buffer capacity too large");
+    std::size_t cap = 1;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+enum { __ring_buffer_default_capacity = 64 };
+
+template<typename T, typename Ref, typename Ptr>
+struct __ring_buffer_iterator {
+    typedef __ring_buffer_iterator<T, T&, T*> iterator;
+    typedef __ring_buffer_iterator<T, const T&, const T*> const_iterator;
+
+    typedef random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef __ring_buffer_iterator self;
+
+    T* buf;
+    size_type mask;
+    size_type pos;      // free-running position, slot is pos & mask
+
+    __ring_buffer_iterator() : buf(0), mask(0), pos(0) { }
+    __ring_buffer_iterator(T* b, size_type m, size_type p) : buf(b), mask(m), pos(p) { }
+    __ring_buffer_iterator(const iterator& x) : buf(x.buf), mask(x.mask), pos(x.pos) { }
+    self& operator=(const self& x) = default;
+
+    reference operator*() const { return buf[pos & mask]; }
+    pointer operator->() const { return &(operator*()); }
+    difference_type operator-(const self& x) const {
+        return difference_type(pos - x.pos);
+    }
+
+    self& operator++() { ++pos; return *this; }
+    self operator++(int) {
+        self tmp = *this;
+        ++pos;
+        return tmp;
+    }
+    self& operator--() { --pos; return *this; }
+    self operator--(int) {
+        self tmp = *this;
+        --pos;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n) { pos += n; return *this; }
+    self operator+(difference_type n) const {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self& operator-=(difference_type n) { pos -= n; return *this; }
+    self operator-(difference_type n) const {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bool operator==(const self& x) const { return pos == x.pos; }
+    bool operator!=(const self& x) const { return pos != x.pos; }
+    bool operator<(const self& x) const { return difference_type(pos - x.pos) < 0; }
+    bool operator>(const self& x) const { return x < *this; }
+    bool operator<=(const self& x) const { return !(x < *this); }
+    bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+template<typename T, typename Alloc = alloc, bool Overwrite = false>
+class ring_buffer {
+public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef __ring_buffer_iterator<T, T&, T*> iterator;
+    typedef __ring_buffer_iterator<T, const T&, const T*> const_iterator;
+
+    // a contiguous piece of the buffer, see array_one() / array_two()
+    typedef stl::pair<pointer, size_type> array_range;
+
+protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+
+    pointer buf;
+    size_type mask;     // capacity - 1
+    size_type head;     // position of front()
+    size_type tail;     // position one past back()
+
+    pointer slot(size_type pos) const { return buf + (pos & mask); }
+
+public:
+    explicit ring_buffer(size_type capacity = __ring_buffer_default_capacity)
+     : buf(0), mask(__ring_buffer_capacity(capacity) - 1), head(0), tail(0)
+    {
+        buf = data_allocator::allocate(mask + 1);
+    }
+    ring_buffer(const ring_buffer& x) : ring_buffer(x.capacity()) {
+        for (const_iterator cur = x.begin(); cur != x.end(); ++cur)
+            push_back(*cur);
+    }
+    ring_buffer(ring_buffer&& x) : ring_buffer(1) {
+        swap(x);
+    }
+    ring_buffer& operator=(const ring_buffer& x) {
+        if (this != &x) {
+            ring_buffer tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    ring_buffer& operator=(ring_buffer&& x) {
+        if (this != &x) {
+            clear();
+            swap(x);
+        }
+        return *this;
+    }
+    ~ring_buffer() {
+        clear();
+        data_allocator::deallocate(buf, mask + 1);
+    }
+
+    void swap(ring_buffer& x) {
+        std::swap(buf, x.buf);
+        std::swap(mask, x.mask);
+        std::swap(head, x.head);
+        std::swap(tail, x.tail);
+    }
+
+public:
+    iterator begin() { return iterator(buf, mask, head); }
+    iterator end() { return iterator(buf, mask, tail); }
+    const_iterator begin() const { return const_iterator(buf, mask, head); }
+    const_iterator end() const { return const_iterator(buf, mask, tail); }
+
+    reference operator[](size_type n) { return *slot(head + n); }
+    const_reference operator[](size_type n) const { return *slot(head + n); }
+
+    reference front() { return *slot(head); }
+    const_reference front() const { return *slot(head); }
+    reference back() { return *slot(tail - 1); }
+    const_reference back() const { return *slot(tail - 1); }
+
+    size_type size() const { return tail - head; }
+    size_type capacity() const { return mask + 1; }
+    size_type max_size() const { return capacity(); }
+    bool empty() const { return tail == head; }
+    bool full() const { return size() == capacity(); }
+
+    // The occupied slots as at most two contiguous arrays, front first.
+    array_range array_one() {
+        size_type first = head & mask;
+        size_type n = size();
+        return array_range(buf + first, n < capacity() - first ? n : capacity() - first);
+    }
+    array_range array_two() {
+        size_type n = size() - array_one().second;
+        return array_range(buf, n);
+    }
+
+public:
+    void push_back(const value_type& x) { emplace_back(x); }
+    void push_back(value_type&& x) { emplace_back(std::move(x)); }
+    void push_front(const value_type& x) { emplace_front(x); }
+    void push_front(value_type&& x) { emplace_front(std::move(x)); }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (full()) {
+            if (!Overwrite)
+                throw std::length_error("ring_buffer is full");
+            // construct first, x may refer to front()
+            value_type tmp(std::forward<Args>(args)...);
+            pop_front();
+            construct(slot(tail), std::move(tmp));
+        } else {
+            construct(slot(tail), std::forward<Args>(args)...);
+        }
+        ++tail;
+    }
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        if (full()) {
+            if (!Overwrite)
+                throw std::length_error("ring_buffer is full");
+            value_type tmp(std::forward<Args>(args)...);
+            pop_back();
+            construct(slot(head - 1), std::move(tmp));
+        } else {
+            construct(slot(head - 1), std::forward<Args>(args)...);
+        }
+        --head;
+    }
+
+    // Batch append: the elements land in at most two contiguous pieces.
+    template<typename ForwardIterator>
+    void push_back(ForwardIterator first, ForwardIterator last);
+
+    void pop_back() {
+        --tail;
+        memory::destroy(slot(tail));
+    }
+    void pop_front() {
+        memory::destroy(slot(head));
+        ++head;
+    }
+    // Batch removal of the n front elements.
+    void pop_front(size_type n) {
+        destroy_range(head, n);
+        head += n;
+    }
+
+    void clear() {
+        destroy_range(head, size());
+        head = tail = 0;
+    }
+
+protected:
+    void destroy_range(size_type pos, size_type n) {
+        size_type first = pos & mask;
+        size_type n1 = n < capacity() - first ? n : capacity() - first;
+        memory::destroy(buf + first, buf + first + n1);
+        memory::destroy(buf, buf + (n - n1));
+    }
+};
+
+template<typename T, typename Alloc, bool Overwrite>
+template<typename ForwardIterator>
+void ring_buffer<T, Alloc, Overwrite>::push_back(ForwardIterator first, ForwardIterator last)
+{
+    size_type n = stl::distance(first, last);
+    if (n > capacity() - size()) {
+        if (!Overwrite)
+            throw std::length_error("ring_buffer is full");
+        if (n >= capacity()) {
+            // only the last capacity() elements survive
+            stl::advance(first, n - capacity());
+            n = capacity();
+            clear();
+        } else {
+            pop_front(n - (capacity() - size()));
+        }
+    }
+    size_type start = tail & mask;
+    size_type n1 = n < capacity() - start ? n : capacity() - start;
+    ForwardIterator mid = first;
+    stl::advance(mid, n1);
+    memory::uninitialized_copy(first, mid, buf + start);
+    try {
+        memory::uninitialized_copy(mid, last, buf);
+    }
+    catch (...) {
+        memory::destroy(buf + start, buf + start + n1);
+        throw;
+    }
+    tail += n;
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_RING_BUFFER_ */
@@ -0,0 +1,320 @@
+#ifndef STL_IMPL_SEARCHER_
+#define STL_IMPL_SEARCHER_
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include "iterator.hpp"
+#include "functional.hpp"
+#include "utility.hpp"
+#include "__type_traits.hpp"
+#include "__simd.hpp"
+
+namespace stl {
+
+// Searchers preprocess a pattern once and then find it in any number of
+// haystacks: searcher(first, last) returns the [begin, end) of the first
+// occurrence, or (last, last).  stl::search(first, last, searcher) returns
+// just the begin.  Like the std ones they keep iterators into the pattern,
+// which must outlive them.
+//
+// boyer_moore_horspool_searcher compares the last element of the window
+// first and on a mismatch shifts the window by how far that element is from
+// the end of the pattern; shifts of about the pattern length make it
+// sub-linear on average, but the worst case is O(n m).
+// two_way_searcher (Crochemore-Perrin) runs in O(n + m) time in the worst
+// case and O(1) extra space; it needs the elements ordered by comp.
+// On byte strings (pointers to char, signed char or unsigned char, elements
+// compared with ==) both skip to candidate positions with a vector filter.
+
+// Pointers to the same 1-byte integer type, compared with Predicate.
+template<typename PatternIterator, typename Iterator, typename Predicate>
+struct __searcher_bytes {
+    typedef typename std::remove_cv<typename std::remove_pointer<PatternIterator>::type>::type T;
+    typedef typename std::remove_cv<typename std::remove_pointer<Iterator>::type>::type U;
+    enum { value = std::is_pointer<PatternIterator>::value && std::is_pointer<Iterator>::value
+                   && std::is_same<T, U>::value && std::is_integral<T>::value
+                   && sizeof(T) == 1 && !std::is_same<T, bool>::value
+                   && (std::is_same<Predicate, equal_to<T> >::value
+                       || std::is_same<Predicate, std::equal_to<T> >::value) };
+    typedef typename std::conditional<value, __traits::__true_type,
+                                      __traits::__false_type>::type is_bytes;
+};
+
+// Boyer-Moore-Horspool
+// The shift table has 256 entries indexed by the low byte of the hash, and
+// keeps the smallest shift of the elements sharing an entry; that is exact
+// for bytes and safe for anything else.
+template<typename RandomAccessIterator,
+         typename Hash = std::hash<typename iterator_traits<RandomAccessIterator>::value_type>,
+         typename BinaryPredicate = equal_to<typename iterator_traits<RandomAccessIterator>::value_type> >
+class boyer_moore_horspool_searcher {
+public:
+    typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+
+protected:
+    enum { table_size = 256 };
+
+    RandomAccessIterator pattern;
+    difference_type m;
+    Hash hash;
+    BinaryPredicate pred;
+    difference_type shift[table_size];
+
+    template<typename Value>
+    difference_type skip(const Value& x) const { return shift[hash(x) & (table_size - 1)]; }
+
+    template<typename RandomAccessIterator2>
+    pair<RandomAccessIterator2, RandomAccessIterator2>
+    search(RandomAccessIterator2 first, RandomAccessIterator2 last, __traits::__false_type) const;
+    template<typename T>
+    pair<T*, T*> search(T* first, T* last, __traits::__true_type) const;
+
+public:
+    boyer_moore_horspool_searcher(RandomAccessIterator pat_first, RandomAccessIterator pat_last,
+                                  Hash hf = Hash(), BinaryPredicate pred = BinaryPredicate());
+
+    template<typename RandomAccessIterator2>
+    pair<RandomAccessIterator2, RandomAccessIterator2>
+    operator()(RandomAccessIterator2 first, RandomAccessIterator2 last) const {
+        typedef typename __searcher_bytes<RandomAccessIterator, RandomAccessIterator2,
+                                          BinaryPredicate>::is_bytes is_bytes;
+        return search(first, last, is_bytes());
+    }
+};
+
+template<typename RandomAccessIterator, typename Hash, typename BinaryPredicate>
+boyer_moore_horspool_searcher<RandomAccessIterator, Hash, BinaryPredicate>::
+boyer_moore_horspool_searcher(RandomAccessIterator pat_first, RandomAccessIterator pat_last,
+                              Hash hf, BinaryPredicate p)
+ : pattern(pat_first), m(pat_last - pat_first), hash(hf), pred(p)
+{
+    for (int i = 0; i < table_size; ++i)
+        shift[i] = m;
+    // later elements overwrite earlier ones with smaller shifts
+    for (difference_type i = 0; i + 1 < m; ++i)
+        shift[hash(pattern[i]) & (table_size - 1)] = m - 1 - i;
+}
+
+template<typename RandomAccessIterator, typename Hash, typename BinaryPredicate>
+template<typename RandomAccessIterator2>
+pair<RandomAccessIterator2, RandomAccessIterator2>
+boyer_moore_horspool_searcher<RandomAccessIterator, Hash, BinaryPredicate>::
+search(RandomAccessIterator2 first, RandomAccessIterator2 last, __traits::__false_type) const
+{
+    typedef pair<RandomAccessIterator2, RandomAccessIterator2> result;
+    if (m == 0)
+        return result(first, first);
+    if (last - first < m)
+        return result(last, last);
+    for (RandomAccessIterator2 end = last - m; ; ) {
+        const value_type& back = *(first + (m - 1));
+        if (pred(back, pattern[m - 1])) {
+            difference_type i = 0;
+            while (i < m - 1 && pred(first[i], pattern[i]))
+                ++i;
+            if (i == m - 1)
+                return result(first, first + m);
+        }
+        difference_type step = skip(back);
+        if (end - first < step)
+            return result(last, last);
+        first += step;
+    }
+}
+
+template<typename RandomAccessIterator, typename Hash, typename BinaryPredicate>
+template<typename T>
+pair<T*, T*>
+boyer_moore_horspool_searcher<RandomAccessIterator, Hash, BinaryPredicate>::
+search(T* first, T* last, __traits::__true_type) const
+{
+    const T* found;
+    if (m >= 2 && last - first >= m
+        && ::stl::__simd_search_bytes<typename std::remove_cv<T>::type>(first, last, pattern,
+                                                                        m, found)) {
+        T* p = first + (found - first);
+        return found == last ? pair<T*, T*>(last, last) : pair<T*, T*>(p, p + m);
+    }
+    return search(first, last, __traits::__false_type());
+}
+
+// Two-way
+// The pattern is cut at a critical factorization u v, found from the
+// maximal suffixes for comp and for its reverse.  v is matched left to
+// right and u right to left; a mismatch in v shifts by the matched
+// length, a match of v and mismatch in u by the period.  When u is a
+// suffix of the period-long prefix (a periodic pattern) the part already
+// known to match after a period shift is remembered and not compared
+// again.
+template<typename RandomAccessIterator,
+         typename Compare = less<typename iterator_traits<RandomAccessIterator>::value_type> >
+class two_way_searcher {
+public:
+    typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+    typedef std::size_t size_type;
+
+protected:
+    RandomAccessIterator pattern;
+    size_type m;
+    size_type suffix;   // start of v
+    size_type period;
+    bool periodic;
+    Compare comp;
+
+    size_type max_suffix(bool reversed, size_type& p) const;
+
+    // The next window at or after j that can match, n - m + 1 if there is
+    // none: the first one whose element at suffix matches, or on byte
+    // strings the first one whose first and last elements match, found with
+    // the vector filter.
+    template<typename RandomAccessIterator2>
+    size_type candidate(RandomAccessIterator2 first, size_type j, size_type n,
+                        __traits::__false_type) const;
+    template<typename T>
+    size_type candidate(T* first, size_type j, size_type n, __traits::__true_type) const;
+
+public:
+    two_way_searcher(RandomAccessIterator pat_first, RandomAccessIterator pat_last,
+                     Compare c = Compare());
+
+    template<typename RandomAccessIterator2>
+    pair<RandomAccessIterator2, RandomAccessIterator2>
+    operator()(RandomAccessIterator2 first, RandomAccessIterator2 last) const;
+};
+
+// Maximal suffix of the pattern for comp, or for its reverse: returns the
+// position before it (size_type(-1) for the whole pattern) and its period.
+template<typename RandomAccessIterator, typename Compare>
+typename two_way_searcher<RandomAccessIterator, Compare>::size_type
+two_way_searcher<RandomAccessIterator, Compare>::max_suffix(bool reversed, size_type& p) const
+{
+    size_type ms = size_type(-1), j = 0, k = 1;
+    p = 1;
+    while (j + k < m) {
+        const value_type& a = pattern[j + k];
+        const value_type& b = pattern[ms + k];
+        if (reversed ? comp(b, a) : comp(a, b)) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        }
+        else if (reversed ? comp(a, b) : comp(b, a)) {
+            ms = j++;
+            k = p = 1;
+        }
+        else if (k != p)
+            ++k;
+        else {
+            j += p;
+            k = 1;
+        }
+    }
+    return ms;
+}
+
+template<typename RandomAccessIterator, typename Compare>
+two_way_searcher<RandomAccessIterator, Compare>::
+two_way_searcher(RandomAccessIterator pat_first, RandomAccessIterator pat_last, Compare c)
+ : pattern(pat_first), m(pat_last - pat_first), suffix(0), period(1), periodic(false), comp(c)
+{
+    size_type p, q;
+    size_type ms = max_suffix(false, p);
+    size_type rs = max_suffix(true, q);
+    // the later of the two cuts is critical
+    if (rs + 1 < ms + 1) {
+        suffix = ms + 1;
+        period = p;
+    }
+    else {
+        suffix = rs + 1;
+        period = q;
+    }
+    periodic = suffix + period <= m;
+    for (size_type i = 0; periodic && i < suffix; ++i)
+        periodic = pattern[i] == pattern[i + period];
+    if (!periodic) {
+        // no overlap is possible: the shift after a match of v can be longer
+        period = (suffix > m - suffix ? suffix : m - suffix) + 1;
+    }
+}
+
+template<typename RandomAccessIterator, typename Compare>
+template<typename RandomAccessIterator2>
+inline typename two_way_searcher<RandomAccessIterator, Compare>::size_type
+two_way_searcher<RandomAccessIterator, Compare>::
+candidate(RandomAccessIterator2 first, size_type j, size_type n, __traits::__false_type) const
+{
+    const value_type& x = pattern[suffix];
+    while (j <= n - m && !(first[j + suffix] == x))
+        ++j;
+    return j;
+}
+
+template<typename RandomAccessIterator, typename Compare>
+template<typename T>
+inline typename two_way_searcher<RandomAccessIterator, Compare>::size_type
+two_way_searcher<RandomAccessIterator, Compare>::
+candidate(T* first, size_type j, size_type n, __traits::__true_type) const
+{
+    typedef typename std::remove_cv<T>::type V;
+    const V* p = ::stl::__simd_find_pair<V>(first + j, first + (n - m + 1), m - 1,
+                                           pattern[0], pattern[m - 1]);
+    return size_type(p - first);
+}
+
+template<typename RandomAccessIterator, typename Compare>
+template<typename RandomAccessIterator2>
+pair<RandomAccessIterator2, RandomAccessIterator2>
+two_way_searcher<RandomAccessIterator, Compare>::
+operator()(RandomAccessIterator2 first, RandomAccessIterator2 last) const
+{
+    typedef pair<RandomAccessIterator2, RandomAccessIterator2> result;
+    typedef __searcher_bytes<RandomAccessIterator, RandomAccessIterator2,
+                             equal_to<value_type> > bytes;
+    typedef typename bytes::is_bytes is_bytes;
+    if (m == 0)
+        return result(first, first);
+    size_type n = last - first;
+    if (n < m)
+        return result(last, last);
+
+    // the window moves right only, so skipping windows that cannot match
+    // keeps the search linear
+    const bool vector = bytes::value && ::stl::__simd_level() >= __simd_sse2;
+    size_type j = 0, memory = 0;
+    while (j <= n - m) {
+        if (memory == 0) {
+            j = vector ? candidate(first, j, n, is_bytes())
+                       : candidate(first, j, n, __traits::__false_type());
+            if (j > n - m)
+                break;
+        }
+        size_type i = suffix > memory ? suffix : memory;
+        while (i < m && pattern[i] == first[i + j])
+            ++i;
+        if (i < m) {
+            j += i - suffix + 1;
+            memory = 0;
+            continue;
+        }
+        i = suffix;
+        while (i > memory && pattern[i - 1] == first[i - 1 + j])
+            --i;
+        if (i <= memory)
+            return result(first + j, first + (j + m));
+        j += period;
+        memory = periodic ? m - period : 0;
+    }
+    return result(last, last);
+}
+
+template<typename ForwardIterator, typename Searcher>
+inline ForwardIterator search(ForwardIterator first, ForwardIterator last, const Searcher& searcher) {
+    return searcher(first, last).first;
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_SEARCHER_ */
@@ -0,0 +1,186 @@
+#ifndef STL_IMPL_SPSC_QUEUE_
+#define STL_IMPL_SPSC_QUEUE_
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include "memory/alloc.hpp"
+#include "ring_buffer.hpp"
+#include "__concurrency.hpp"
+
+namespace stl {
+
+using namespace memory;
+
+// Bounded single-producer/single-consumer queue.
+// Exactly one thread may call the producer side (push, try_push) and exactly
+// one other thread the consumer side (front, pop, try_pop); both sides are
+// wait-free.  Like ring_buffer the capacity is a power of two and head/tail
+// are free-running counters.  tail is written only by the producer, head
+// only by the consumer, and each sits on its own cache line next to the
+// owner's cached copy of the other index, so the line holding the opposite
+// index is only touched when the cached copy says the queue is full/empty.
+template<typename T, typename Alloc = alloc>
+class spsc_queue {
+public:
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef std::size_t size_type;
+
+protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+
+    value_type* buf;
+    size_type mask;
+
+    alignas(__cache_line_size) std::atomic<size_type> tail;     // producer
+    size_type head_cache;
+    alignas(__cache_line_size) std::atomic<size_type> head;     // consumer
+    size_type tail_cache;
+
+    value_type* slot(size_type pos) const { return buf + (pos & mask); }
+
+public:
+    explicit spsc_queue(size_type capacity = 1024)
+     : buf(0), mask(__ring_buffer_capacity(capacity) - 1),
+       tail(0), head_cache(0), head(0), tail_cache(0)
+    {
+        buf = data_allocator::allocate(mask + 1);
+    }
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+    ~spsc_queue() {
+        size_type h = head.load(std::memory_order_relaxed);
+        size_type t = tail.load(std::memory_order_relaxed);
+        for (; h != t; ++h)
+            memory::destroy(slot(h));
+        data_allocator::deallocate(buf, mask + 1);
+    }
+
+public:
+    size_type capacity() const { return mask + 1; }
+    // Exact when called from either side while the other side is idle,
+    // otherwise a snapshot.
+    size_type size() const {
+        size_type h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+    bool empty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+public:
+    // producer side
+    template<typename... Args>
+    bool try_emplace(Args&&... args);
+    bool try_push(const value_type& x) { return try_emplace(x); }
+    bool try_push(value_type&& x) { return try_emplace(std::move(x)); }
+    // Push as many elements of [first, last) as fit, publishing them with a
+    // single store.  Returns the first element that was not pushed.
+    template<typename InputIterator>
+    InputIterator try_push(InputIterator first, InputIterator last);
+
+    // Spins while the queue is full.
+    void push(const value_type& x) {
+        for (__backoff wait; !try_push(x); wait()) { }
+    }
+    void push(value_type&& x) {
+        for (__backoff wait; !try_emplace(std::move(x)); wait()) { }
+    }
+
+public:
+    // consumer side; front() and pop() require !empty()
+    reference front() { return *slot(head.load(std::memory_order_relaxed)); }
+    const_reference front() const { return *slot(head.load(std::memory_order_relaxed)); }
+    void pop() {
+        size_type h = head.load(std::memory_order_relaxed);
+        memory::destroy(slot(h));
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    bool try_pop(value_type& x);
+    // Move up to n elements into out, releasing their slots with a single
+    // store.  Returns how many were popped.
+    template<typename OutputIterator>
+    size_type try_pop(OutputIterator out, size_type n);
+};
+
+template<typename T, typename Alloc>
+template<typename... Args>
+bool spsc_queue<T, Alloc>::try_emplace(Args&&... args)
+{
+    size_type t = tail.load(std::memory_order_relaxed);
+    if (t - head_cache == capacity()) {
+        head_cache = head.load(std::memory_order_acquire);
+        if (t - head_cache == capacity())
+            return false;
+    }
+    construct(slot(t), std::forward<Args>(args)...);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename Alloc>
+template<typename InputIterator>
+InputIterator spsc_queue<T, Alloc>::try_push(InputIterator first, InputIterator last)
+{
+    size_type t = tail.load(std::memory_order_relaxed);
+    head_cache = head.load(std::memory_order_acquire);
+    size_type room = capacity() - (t - head_cache);
+    size_type n = 0;
+    try {
+        for (; n < room && first != last; ++n, ++first)
+            construct(slot(t + n), *first);
+    }
+    catch (...) {
+        tail.store(t + n, std::memory_order_release);
+        throw;
+    }
+    tail.store(t + n, std::memory_order_release);
+    return first;
+}
+
+template<typename T, typename Alloc>
+bool spsc_queue<T, Alloc>::try_pop(value_type& x)
+{
+    size_type h = head.load(std::memory_order_relaxed);
+    if (h == tail_cache) {
+        tail_cache = tail.load(std::memory_order_acquire);
+        if (h == tail_cache)
+            return false;
+    }
+    x = std::move(*slot(h));
+    memory::destroy(slot(h));
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename Alloc>
+template<typename OutputIterator>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::try_pop(OutputIterator out, size_type n)
+{
+    size_type h = head.load(std::memory_order_relaxed);
+    tail_cache = tail.load(std::memory_order_acquire);
+    size_type avail = tail_cache - h;
+    if (n > avail) n = avail;
+    size_type i = 0;
+    try {
+        for (; i < n; ++i, ++out) {
+            *out = std::move(*slot(h + i));
+            memory::destroy(slot(h + i));
+        }
+    }
+    catch (...) {
+        memory::destroy(slot(h + i));
+        head.store(h + i + 1, std::memory_order_release);
+        throw;
+    }
+    head.store(h + n, std::memory_order_release);
+    return n;
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_SPSC_QUEUE_ */
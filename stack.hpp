@@ -2,12 +2,15 @@
 #define STL_IMPL_STACK_
 
 #include "deque.hpp"
+#include <utility>
 
 namespace stl {
 template<typename T, typename Sequence = stl::deque<T>>
 class stack {
 public:
     stack() = default;
+    explicit stack(const Sequence& s) : c(s) { }
+    explicit stack(Sequence&& s) : c(std::move(s)) { }
 
 public:
     typedef typename Sequence::value_type       value_type;
@@ -0,0 +1,210 @@
+#ifndef STL_IMPL_STATIC_SEARCH_INDEX_
+#define STL_IMPL_STATIC_SEARCH_INDEX_
+
+#include <cstddef>
+#include <utility>
+#include "memory/alloc.hpp"
+#include "memory/utils.hpp"
+#include "functional.hpp"
+#include "vector.hpp"
+
+namespace stl {
+
+// Read-only lower_bound index over a sorted sequence.
+// The elements are stored in Eytzinger (breadth-first) order: the root at
+// slot 1, the children of slot k at 2k and 2k + 1.  The first levels of the
+// search share a handful of cache lines however large the index is, and
+// the 64-byte line holding all the descendants four levels (for int) below
+// the current node is prefetched while those levels are walked, so a
+// lookup costs about one memory latency per four levels instead of one per
+// level.  Each step is a conditional add, with no branch to mispredict.
+// lower_bound(x) returns the position x would have in the original sorted
+// sequence, like stl::lower_bound(first, last, x) - first.
+
+enum { __search_index_cacheline = 64 };
+
+// elements per cache line, rounded down to a power of two
+template<typename T>
+struct __search_index_block {
+    enum { raw = sizeof(T) < __search_index_cacheline ? __search_index_cacheline / sizeof(T) : 1 };
+    enum { value = raw >= 16 ? 16 : raw >= 8 ? 8 : raw >= 4 ? 4 : raw >= 2 ? 2 : 1 };
+};
+
+// number of trailing one bits of k
+inline int __search_index_trailing_ones(std::size_t k)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return ~k == 0 ? int(sizeof(k) * 8) : __builtin_ctzll((unsigned long long)~k);
+#else
+    int n = 0;
+    for ( ; k & 1; k >>= 1) ++n;
+    return n;
+#endif
+}
+
+// floor(log2(k)), k > 0
+inline int __search_index_log2(std::size_t k)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll((unsigned long long)k);
+#else
+    int n = 0;
+    while (k >>= 1) ++n;
+    return n;
+#endif
+}
+
+template<typename T, typename Compare = less<T>, typename Alloc = memory::alloc>
+class static_search_index {
+public:
+    typedef T value_type;
+    typedef const value_type& const_reference;
+    typedef std::size_t size_type;
+
+protected:
+    typedef memory::simple_alloc<char, Alloc> data_allocator;
+
+    char* storage;
+    value_type* tree;   // slots 1..n, slot 0 is left unconstructed
+    size_type n;
+    int height;         // levels in the tree, the last one maybe partial
+    Compare comp;
+
+    size_type rank(size_type k) const;
+
+    // Slot 0 is put on a cache-line boundary, so the 2^i descendants i
+    // levels below a node share as few lines as possible.
+    size_type storage_size() const { return (n + 1) * sizeof(T) + __search_index_cacheline; }
+    void allocate_tree() {
+        storage = data_allocator::allocate(storage_size());
+        std::size_t addr = reinterpret_cast<std::size_t>(storage);
+        std::size_t aligned = (addr + __search_index_cacheline - 1)
+                            & ~std::size_t(__search_index_cacheline - 1);
+        tree = reinterpret_cast<value_type*>(storage + (aligned - addr));
+    }
+    void deallocate_tree() { data_allocator::deallocate(storage, storage_size()); }
+
+public:
+    template<typename RandomAccessIterator>
+    static_search_index(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare c = Compare());
+    explicit static_search_index(const vector<T>& sorted, Compare c = Compare())
+     : static_search_index(sorted.begin(), sorted.end(), c) { }
+    static_search_index(const static_search_index& x)
+     : storage(0), tree(0), n(x.n), height(x.height), comp(x.comp)
+    {
+        allocate_tree();
+        try {
+            memory::uninitialized_copy(x.tree + 1, x.tree + n + 1, tree + 1);
+        }
+        catch (...) {
+            deallocate_tree();
+            throw;
+        }
+    }
+    static_search_index(static_search_index&& x)
+     : storage(0), tree(0), n(0), height(0), comp(x.comp)
+    {
+        swap(x);
+    }
+    static_search_index& operator=(static_search_index x) {
+        swap(x);
+        return *this;
+    }
+    ~static_search_index() {
+        if (storage) {  // not moved from
+            memory::destroy(tree + 1, tree + n + 1);
+            deallocate_tree();
+        }
+    }
+
+    void swap(static_search_index& x) {
+        std::swap(storage, x.storage);
+        std::swap(tree, x.tree);
+        std::swap(n, x.n);
+        std::swap(height, x.height);
+        std::swap(comp, x.comp);
+    }
+
+public:
+    size_type size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    // first position whose element is not less than x, size() if none
+    size_type lower_bound(const value_type& x) const;
+    bool contains(const value_type& x) const {
+        size_type k = find_slot(x);
+        return k != 0 && !comp(x, tree[k]);
+    }
+
+protected:
+    // Eytzinger slot of the lower bound, 0 if there is none
+    size_type find_slot(const value_type& x) const;
+};
+
+template<typename T, typename Compare, typename Alloc>
+template<typename RandomAccessIterator>
+static_search_index<T, Compare, Alloc>::static_search_index(RandomAccessIterator first,
+                                                            RandomAccessIterator last,
+                                                            Compare c)
+ : storage(0), tree(0), n(last - first), height(0), comp(c)
+{
+    allocate_tree();
+    if (n > 0)
+        height = __search_index_log2(n) + 1;
+    size_type k = 1;
+    try {
+        for ( ; k <= n; ++k)
+            memory::construct(tree + k, *(first + rank(k)));
+    }
+    catch (...) {
+        memory::destroy(tree + 1, tree + k);
+        deallocate_tree();
+        throw;
+    }
+}
+
+// In-order position of slot k.  In the perfect tree of the same height the
+// slot at depth d is at (2 (k - 2^d) + 1) 2^(height - 1 - d) - 1, and the
+// leaves of the last level sit at the even positions; subtract the leaves
+// missing from the end of the last level that would come before it.
+template<typename T, typename Compare, typename Alloc>
+inline typename static_search_index<T, Compare, Alloc>::size_type
+static_search_index<T, Compare, Alloc>::rank(size_type k) const
+{
+    int depth = __search_index_log2(k);
+    size_type pos = ((2 * (k - (size_type(1) << depth)) + 1) << (height - 1 - depth)) - 1;
+    size_type leaves = n - ((size_type(1) << (height - 1)) - 1);
+    size_type before = (pos + 1) / 2;
+    return before > leaves ? pos - (before - leaves) : pos;
+}
+
+template<typename T, typename Compare, typename Alloc>
+typename static_search_index<T, Compare, Alloc>::size_type
+static_search_index<T, Compare, Alloc>::find_slot(const value_type& x) const
+{
+    const size_type block = __search_index_block<T>::value;
+    size_type k = 1;
+    while (k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (k * block <= n)
+            __builtin_prefetch(tree + k * block);
+#endif
+        k = 2 * k + comp(tree[k], x);
+    }
+    // the last left turn was at the lower bound: drop the right turns after
+    // it and then that turn itself
+    return k >> (__search_index_trailing_ones(k) + 1);
+}
+
+template<typename T, typename Compare, typename Alloc>
+inline typename static_search_index<T, Compare, Alloc>::size_type
+static_search_index<T, Compare, Alloc>::lower_bound(const value_type& x) const
+{
+    size_type k = find_slot(x);
+    return k == 0 ? n : rank(k);
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_STATIC_SEARCH_INDEX_ */
@@ -65,6 +65,8 @@ int main()
     // assert(not2_test(2, 3) == true);
     assert(bind1st_test(4) == 8);
     assert(bind2nd_test(3) == 6);
+    assert(stl::bind2nd(stl::minus<int>(), 3)(10) == 7);
+    assert(stl::bind1st(stl::minus<int>(), 3)(10) == -7);
     assert(pointer_to_unary_function_test(2) == -2);
     assert(pointer_to_binary_function_test(2, 3) == 5);
 
@@ -10,6 +10,124 @@
 #include <string>
 #include "../list.hpp"
 #include "../deque.hpp"
+#include <random>
+#include <limits>
+
+// fill and fill_n on T* at every vector level, streaming or not, from
+// every start offset within a cache line, leaving the neighbours alone
+template<typename T>
+static void check_contiguous_fill(T value, T guard)
+{
+    std::vector<T> v(400);
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        for (std::size_t threshold : {std::size_t(0), stl::__simd_stream_threshold()}) {
+            std::size_t saved = stl::__simd_stream_threshold();
+            stl::__simd_stream_threshold() = threshold;
+            for (std::size_t off = 1; off <= 64 / sizeof(T) + 1; ++off) {
+                for (std::size_t len = 0; off + len < v.size(); len += len < 80 ? 1 : 37) {
+                    std::fill(v.begin(), v.end(), guard);
+                    if (len % 2)
+                        stl::fill(v.data() + off, v.data() + off + len, value);
+                    else
+                        assert(stl::fill_n(v.data() + off, len, value) == v.data() + off + len);
+                    for (std::size_t i = 0; i < v.size(); ++i)
+                        assert(std::memcmp(&v[i], i >= off && i < off + len ? &value : &guard,
+                                           sizeof(T)) == 0);
+                }
+            }
+            stl::__simd_stream_threshold() = saved;
+        }
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
+// copy, copy_backward and uninitialized_copy on T* through the copy engine,
+// streaming or not, at every alignment and overlapping either way
+template<typename T>
+static void check_contiguous_copy()
+{
+    std::vector<T> src(1200), dst(1300), expect;
+    for (std::size_t i = 0; i < src.size(); ++i)
+        src[i] = T(i * 7 + 1);
+    std::size_t saved = stl::__simd_stream_threshold();
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        for (std::size_t threshold : {std::size_t(0), saved}) {
+            stl::__simd_stream_threshold() = threshold;
+            for (std::size_t off = 0; off < 40 / sizeof(T) + 2; ++off) {
+                for (std::size_t len : {0, 1, 31, 64, 255, 1000, 1199}) {
+                    const T* first = src.data() + (src.size() - len) / 2;
+                    std::fill(dst.begin(), dst.end(), T(0));
+                    assert(stl::copy(first, first + len, dst.data() + off)
+                           == dst.data() + off + len);
+                    assert(std::equal(first, first + len, dst.data() + off));
+                    assert(dst[off + len] == T(0) && (off == 0 || dst[off - 1] == T(0)));
+
+                    std::fill(dst.begin(), dst.end(), T(0));
+                    assert(stl::copy_backward(first, first + len, dst.data() + off + len)
+                           == dst.data() + off);
+                    assert(std::equal(first, first + len, dst.data() + off));
+
+                    std::fill(dst.begin(), dst.end(), T(0));
+                    assert(stl::memory::uninitialized_copy(first, first + len, dst.data() + off)
+                           == dst.data() + off + len);
+                    assert(std::equal(first, first + len, dst.data() + off));
+
+                    // overlapping moves, left with copy and right with copy_backward
+                    if (off + len <= src.size()) {
+                        std::copy(src.begin(), src.begin() + len + off, dst.begin());
+                        expect.assign(dst.begin(), dst.end());
+                        std::copy(expect.begin() + off, expect.begin() + off + len, expect.begin());
+                        stl::copy(dst.data() + off, dst.data() + off + len, dst.data());
+                        assert(dst == expect);
+                        std::copy(src.begin(), src.begin() + len, dst.begin());
+                        expect.assign(dst.begin(), dst.end());
+                        std::copy_backward(expect.begin(), expect.begin() + len,
+                                           expect.begin() + off + len);
+                        stl::copy_backward(dst.data(), dst.data() + len, dst.data() + off + len);
+                        assert(dst == expect);
+                    }
+                }
+            }
+        }
+    }
+    stl::__simd_stream_threshold() = saved;
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
+// equal, mismatch, lexicographical_compare on T* against std, at every
+// vector level, with the first difference at every position
+template<typename T>
+static void check_contiguous_compare(std::mt19937& gen)
+{
+    std::vector<T> a(200), b;
+    for (auto& x : a)
+        x = T(gen() % 100);
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        for (std::size_t len = 0; len <= a.size(); len += len < 70 ? 1 : 13) {
+            const T* p = a.data();
+            for (std::size_t at = 0; at <= len; ++at) {
+                b.assign(p, p + len);
+                b.push_back(T(1));
+                if (at < len)
+                    b[at] = T(b[at] + 1 - 2 * int(gen() % 2));
+                const T* q = b.data();
+                assert(stl::equal(p, p + len, q) == std::equal(p, p + len, q));
+                assert(stl::mismatch(p, p + len, q) == std::mismatch(p, p + len, q));
+                for (std::size_t len2 : {len, at, len + 1}) {
+                    assert(stl::lexicographical_compare(p, p + len, q, q + len2)
+                           == std::lexicographical_compare(p, p + len, q, q + len2));
+                    assert(stl::lexicographical_compare(q, q + len2, p, p + len)
+                           == std::lexicographical_compare(q, q + len2, p, p + len));
+                }
+                if (at + 16 < len) at += 7;
+            }
+        }
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
 
 #ifndef _TESTS_ALGORITHM
 int main()
@@ -45,6 +163,38 @@ void tests_algobase()
     std::cout << std::endl << std::endl;
     stl::iota(std::begin(std_vec), std::end(std_vec), 1);
 
+    // Contiguous fills take memset or broadcast stores
+    {
+        struct pair16 { short a, b; };
+        struct bytes3 { char c[3]; };
+        check_contiguous_fill<unsigned char>(0x5a, 0xee);
+        check_contiguous_fill<short>(0x1234, -1);
+        check_contiguous_fill<int>(0x01020304, 0);
+        check_contiguous_fill<int>(0, -1);
+        check_contiguous_fill<unsigned long long>(0x0102030405060708ull, 0);
+        check_contiguous_fill<float>(-0.0f, 1.0f);
+        check_contiguous_fill<double>(3.25, -1.0);
+        check_contiguous_fill<const char*>("x", nullptr);
+        check_contiguous_fill<pair16>({1, -2}, {7, 7});
+        check_contiguous_fill<bytes3>({{1, 2, 3}}, {{4, 4, 4}});
+
+        // the value converts to the element type first
+        double dv[20];
+        stl::fill(dv, dv + 20, 7);
+        long long lv[20];
+        assert(stl::fill_n(lv, 20, -1) == lv + 20 && lv[19] == -1);
+        assert(std::count(dv, dv + 20, 7.0) == 20);
+        bool bv[20];
+        stl::fill(bv, bv + 20, 2);
+        assert(std::count(bv, bv + 20, true) == 20);
+        assert(stl::fill_n(bv, -3, false) == bv && bv[0]);
+
+        // and uninitialized storage of a POD type goes the same way
+        stl::vector<int> ivec(1000, 42);
+        assert(std::count(ivec.begin(), ivec.end(), 42) == 1000);
+        std::cout << "fill and fill_n on contiguous ranges passed" << std::endl << std::endl;
+    }
+
     // Iterator swap
     std::cout << "Before iterator swap: ";
     std::copy(std::begin(std_vec), std::end(std_vec), std::ostream_iterator<int>(std::cout, ", "));
@@ -91,6 +241,40 @@ void tests_algobase()
     std::cout << "Mismatch between " << *pos1 << " and " << *pos2
               << std::endl << std::endl;
 
+    // Contiguous ranges of arithmetic types take memcmp or the vector compare
+    {
+        std::mt19937 gen(47);
+        check_contiguous_compare<char>(gen);
+        check_contiguous_compare<signed char>(gen);
+        check_contiguous_compare<unsigned char>(gen);
+        check_contiguous_compare<short>(gen);
+        check_contiguous_compare<int>(gen);
+        check_contiguous_compare<unsigned>(gen);
+        check_contiguous_compare<long long>(gen);
+        check_contiguous_compare<unsigned long long>(gen);
+        check_contiguous_compare<float>(gen);
+        check_contiguous_compare<double>(gen);
+
+        // bytes order as unsigned, and signed bytes do not
+        unsigned char u1[] = {1, 200}, u2[] = {1, 7};
+        signed char s1[] = {1, -56}, s2[] = {1, 7};
+        assert(!stl::lexicographical_compare(u1, u1 + 2, u2, u2 + 2));
+        assert(stl::lexicographical_compare(s1, s1 + 2, s2, s2 + 2));
+        // NaN never compares equal, -0.0 does; unordered pairs are skipped
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        double d1[] = {1.0, nan, 0.0, 3.0}, d2[] = {1.0, nan, -0.0, 4.0};
+        assert(!stl::equal(d1, d1 + 4, d1));
+        assert(stl::mismatch(d1, d1 + 4, d2).first == d1 + 1);
+        assert(stl::equal(d1 + 2, d1 + 3, d2 + 2));
+        assert(stl::lexicographical_compare(d1, d1 + 4, d2, d2 + 4));
+        assert(!stl::lexicographical_compare(d2, d2 + 4, d1, d1 + 4));
+        // the predicate versions see the elements
+        int i1[] = {1, 2, 3}, i2[] = {1, 2, 4};
+        assert(stl::mismatch(i1, i1 + 3, i2, std::equal_to<int>()).first == i1 + 2);
+        std::cout << "equal, mismatch, lexicographical_compare on contiguous ranges passed"
+                  << std::endl << std::endl;
+    }
+
     // Swap
     std::cout << "Before swaping, a = " << a << ", b = " << b << std::endl;
     stl::swap(a, b);
@@ -150,6 +334,14 @@ void tests_algobase()
     }
     std::cout << std::endl << std::endl;
 
+    // Copies of trivially copyable types go through the copy engine
+    check_contiguous_copy<char>();
+    check_contiguous_copy<short>();
+    check_contiguous_copy<int>();
+    check_contiguous_copy<double>();
+    std::cout << "copy, copy_backward, uninitialized_copy on contiguous ranges passed"
+              << std::endl << std::endl;
+
     // Copy backward
     stl::vector<int> ivec;
     for (int i = 0; i < 7; ++i) {
@@ -9,6 +9,10 @@
 #include <vector>
 #include "../__debug.hpp"
 #include <random>
+#include <string>
+#include <sstream>
+#include <cassert>
+#include <limits>
 
 #include "algobase.cpp"
 #include "algoheap.cpp"
@@ -20,6 +24,64 @@ std::ostream& print(Container& c) {
     return std::endl(std::cout);
 }
 
+// count, count_if, find and find_if on T* against plain loops, at every
+// dispatch level and at every alignment of the tail
+template<typename T>
+static void check_simd_scan(std::mt19937& gen)
+{
+    std::vector<T> v(300);
+    for (auto& x : v)
+        x = T(int(gen() % 7) - 3);
+    const T* p = v.data();
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        for (std::size_t len = 0; len <= v.size(); len += len < 70 ? 1 : 23) {
+            for (int k = -4; k <= 4; ++k) {
+                T x = T(k);
+                assert(stl::count(p, p + len, x) == std::count(p, p + len, x));
+                assert(stl::find(p, p + len, x) == std::find(p, p + len, x));
+                auto lt = stl::bind2nd(stl::less<T>(), x);
+                auto ge = stl::bind2nd(stl::greater_equal<T>(), x);
+                auto gt = stl::bind1st(stl::less<T>(), x);          // x < element
+                auto ne = stl::bind2nd(stl::not_equal_to<T>(), x);
+                assert(stl::count_if(p, p + len, lt)
+                       == std::count_if(p, p + len, [&](T e) { return e < x; }));
+                assert(stl::count_if(p, p + len, ge)
+                       == std::count_if(p, p + len, [&](T e) { return e >= x; }));
+                assert(stl::count_if(p, p + len, gt)
+                       == std::count_if(p, p + len, [&](T e) { return x < e; }));
+                assert(stl::find_if(p, p + len, ne)
+                       == std::find_if(p, p + len, [&](T e) { return e != x; }));
+                assert(stl::find_if(p, p + len, gt)
+                       == std::find_if(p, p + len, [&](T e) { return x < e; }));
+            }
+        }
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
+// min_element, max_element, minmax_element on T* against std: the first
+// minimum and maximum, but minmax_element's last maximum
+template<typename T>
+static void check_simd_minmax(std::mt19937& gen)
+{
+    std::vector<T> v(300);
+    for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+        stl::__simd_max_level() = level;
+        for (std::size_t len = 0; len <= v.size(); len += len < 70 ? 1 : 23) {
+            for (auto& x : v)
+                x = T(int(gen() % 201) - 100);
+            const T* p = v.data();
+            assert(stl::min_element(p, p + len) == std::min_element(p, p + len));
+            assert(stl::max_element(p, p + len) == std::max_element(p, p + len));
+            auto mm = stl::minmax_element(p, p + len);
+            auto std_mm = std::minmax_element(p, p + len);
+            assert(mm.first == std_mm.first && mm.second == std_mm.second);
+        }
+    }
+    stl::__simd_max_level() = stl::__simd_avx2;
+}
+
 int main()
 {
     // Tests for algoheap
@@ -67,6 +129,33 @@ int main()
     std::cout << "count_if(ivec, <lambda(int)>);" << std::endl;
     std::cout << stl::count_if(ivec.begin(), ivec.end(), [](int a) { return a > 3; })
               << std::endl << std::endl;
+
+    // Count and find over contiguous arithmetic ranges
+    {
+        std::mt19937 gen(45);
+        check_simd_scan<signed char>(gen);
+        check_simd_scan<unsigned char>(gen);
+        check_simd_scan<short>(gen);
+        check_simd_scan<unsigned short>(gen);
+        check_simd_scan<int>(gen);
+        check_simd_scan<unsigned>(gen);
+        check_simd_scan<long long>(gen);
+        check_simd_scan<unsigned long long>(gen);
+        check_simd_scan<float>(gen);
+        check_simd_scan<double>(gen);
+
+        // values that do not fit the element type never match
+        unsigned char bytes[] = {0, 44, 255, 44};
+        assert(stl::count(bytes, bytes + 4, 300) == 0 && stl::count(bytes, bytes + 4, 255) == 1);
+        assert(stl::find(bytes, bytes + 4, -1) == bytes + 4);
+        assert(stl::find(bytes, bytes + 4, 44L) == bytes + 1);
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        double dv[] = {1.0, nan, -0.0, 2.0};
+        assert(stl::count(dv, dv + 4, nan) == 0 && stl::count(dv, dv + 4, 0.0) == 1);
+        assert(stl::count_if(dv, dv + 4, stl::bind2nd(stl::not_equal_to<double>(), 2.0)) == 3);
+        std::cout << "count, count_if, find, find_if vectorized at every level passed"
+                  << std::endl << std::endl;
+    }
     
     // Find
     {
@@ -161,6 +250,51 @@ int main()
     auto [minIter, maxIter] = stl::minmax_element(ivec.begin(), ivec.end());
     std::cout << "The min element of ivec: " << *minIter << std::endl;
     std::cout << "The max element of ivec: " << *maxIter << std::endl << std::endl;
+    {
+        std::mt19937 gen(46);
+        check_simd_minmax<signed char>(gen);
+        check_simd_minmax<unsigned char>(gen);
+        check_simd_minmax<short>(gen);
+        check_simd_minmax<unsigned short>(gen);
+        check_simd_minmax<int>(gen);
+        check_simd_minmax<unsigned>(gen);
+        check_simd_minmax<long long>(gen);
+        check_simd_minmax<unsigned long long>(gen);
+        check_simd_minmax<float>(gen);
+        check_simd_minmax<double>(gen);
+
+        // a NaN goes back to the loop; -0.0 and 0.0 tie, the first one wins
+        std::vector<double> dv(100, 1.0);
+        dv[10] = -0.0;
+        dv[20] = 0.0;
+        dv[60] = -std::numeric_limits<double>::infinity();
+        assert(stl::min_element(dv.data(), dv.data() + 50) == dv.data() + 10);
+        assert(stl::max_element(dv.data(), dv.data() + 100) == dv.data());
+        dv[30] = std::numeric_limits<double>::quiet_NaN();
+        assert(stl::min_element(dv.data(), dv.data() + 100)
+               == std::min_element(dv.data(), dv.data() + 100));
+        assert(stl::max_element(dv.data(), dv.data() + 100)
+               == std::max_element(dv.data(), dv.data() + 100));
+        auto dmm = stl::minmax_element(dv.data(), dv.data() + 100);
+        auto std_dmm = std::minmax_element(dv.data(), dv.data() + 100);
+        assert(dmm.first == std_dmm.first && dmm.second == std_dmm.second);
+
+        int ia[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+        assert(stl::min_element(ia, ia + 10, std::less<int>()) == ia + 1);
+        assert(stl::max_element(ia, ia + 10, std::less<int>()) == ia + 5);
+        auto by_greater = stl::minmax_element(ia, ia + 10, std::greater<int>());
+        assert(by_greater.first == ia + 5 && by_greater.second == ia + 3);
+        auto by_less = stl::minmax_element(ia, ia + 10, std::less<int>());
+        assert(by_less.first == ia + 1 && by_less.second == ia + 5);
+        stl::list<int> ilist(ia, ia + 10);
+        auto in_list = stl::minmax_element(ilist.begin(), ilist.end());
+        assert(*in_list.first == 1 && *in_list.second == 9);
+        ia[8] = 9;
+        assert(stl::minmax_element(ia, ia + 10).second == ia + 8);
+        assert(stl::minmax_element(ia, ia + 10, std::less<int>()).second == ia + 8);
+        std::cout << "min_element, max_element, minmax_element vectorized at every level passed"
+                  << std::endl << std::endl;
+    }
     
     // Merge
     {
@@ -381,7 +515,43 @@ int main()
         } else {
             std::cout << "not found";
         }
-        std::cout << std::endl << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "equal_range(ivec, 6);" << std::endl;
+        auto range = stl::equal_range(ivec.begin(), ivec.end(), 6);
+        assert(range.first - ivec.begin() == 5 && range.second - ivec.begin() == 7);
+
+        // every probe on every length up to 40, random access and forward,
+        // with and without a comparator
+        stl::list<int> ilist;
+        for (int len = 0; len <= 40; ++len) {
+            std::vector<int> v(len), r(len);
+            for (int i = 0; i < len; ++i)
+                v[i] = i / 5;
+            std::reverse_copy(v.begin(), v.end(), r.begin());
+            for (int x = -1; x <= len / 5 + 1; ++x) {
+                const int* p = v.data();
+                assert(stl::lower_bound(p, p + len, x) == std::lower_bound(p, p + len, x));
+                assert(stl::upper_bound(p, p + len, x) == std::upper_bound(p, p + len, x));
+                auto er = stl::equal_range(p, p + len, x);
+                assert(er.first == std::lower_bound(p, p + len, x)
+                       && er.second == std::upper_bound(p, p + len, x));
+                const int* q = r.data();
+                assert(stl::lower_bound(q, q + len, x, std::greater<int>())
+                       == std::lower_bound(q, q + len, x, std::greater<int>()));
+                assert(stl::upper_bound(q, q + len, x, std::greater<int>())
+                       == std::upper_bound(q, q + len, x, std::greater<int>()));
+                assert(stl::binary_search(q, q + len, x, std::greater<int>())
+                       == std::binary_search(q, q + len, x, std::greater<int>()));
+
+                auto lr = stl::equal_range(ilist.begin(), ilist.end(), x);
+                assert(stl::distance(ilist.begin(), lr.first) == er.first - p);
+                assert(stl::distance(ilist.begin(), lr.second) == er.second - p);
+            }
+            ilist.push_back(len / 5);
+        }
+        std::cout << "lower_bound, upper_bound, equal_range against std passed"
+                  << std::endl << std::endl;
     }
 
     // Permutation
@@ -427,14 +597,49 @@ int main()
         stl::partial_sort(ivec.begin(), ivec.begin() + 4, ivec.end());
         std::cout << "ivec: ";
         ::print(ivec);
+        assert(ivec[0] == 1 && ivec[1] == 2 && ivec[2] == 3 && ivec[3] == 4);
 
-        std::cout << "partial_sort(ivec, +4, <lambda>); "
-                  << stl::debug::warning("(test failed)") << std::endl;  // TODO
-        
+        std::cout << "partial_sort(ivec, +4, <lambda>);" << std::endl;
         stl::partial_sort(ivec.begin(), ivec.begin() + 4, ivec.end(),
                           std::greater<int>());
         std::cout << "ivec: ";
         ::print(ivec);
+        assert(ivec[0] == 10 && ivec[1] == 9 && ivec[2] == 8 && ivec[3] == 7);
+
+        // Partial sort copy, from a list into a shorter and a longer array
+        stl::list<int> ilist;
+        for (int i = 0; i < 10; ++i)
+            ilist.push_back((i * 7) % 10);
+        int top4[4], all12[12];
+        int* end4 = stl::partial_sort_copy(ilist.begin(), ilist.end(), top4, top4 + 4);
+        assert(end4 == top4 + 4 && top4[0] == 0 && top4[3] == 3);
+        int* end12 = stl::partial_sort_copy(ilist.begin(), ilist.end(), all12, all12 + 12,
+                                            std::greater<int>());
+        assert(end12 == all12 + 10 && all12[0] == 9 && all12[9] == 0);
+
+        // Top k, streamed straight from an istream
+        std::istringstream in("42 7 19 88 3 56 91 12 64 30 77 5");
+        stl::vector<int> best;
+        stl::top_k(stl::istream_iterator<int>(in), stl::istream_iterator<int>(), 3,
+                   stl::back_inserter(best), std::greater<int>());
+        std::cout << "top_k(3, >): ";
+        ::print(best);
+        assert(best.size() == 3 && best[0] == 91 && best[1] == 88 && best[2] == 77);
+        std::string words[] = {"pear", "fig", "apple", "kiwi", "banana"};
+        std::string least[2];
+        assert(stl::top_k(words, words + 5, 2, least) == least + 2);
+        assert(least[0] == "apple" && least[1] == "banana");
+        // a huge k costs only what is kept
+        int kept[100];
+        for (int i = 0; i < 100; ++i)
+            kept[i] = (i * 37) % 100;
+        assert(stl::top_k(kept, kept + 100, 1000000000, kept) == kept + 100);
+        for (int i = 0; i < 100; ++i)
+            assert(kept[i] == i);
+        stl::__bounded_heap<int, stl::less<int> > heap(1000000000, stl::less<int>());
+        for (int i = 0; i < 100; ++i)
+            heap.push(i);
+        assert(heap.end() - heap.begin() == 100 && heap.capacity() <= 128);
         std::endl(std::cout);
     }
 
@@ -465,8 +670,250 @@ int main()
         ::print(ivec2) << std::endl;
     }
 
+    // Sort: input patterns
+    {
+        const int n = 100000;
+        std::mt19937 gen(42);
+        std::vector<std::vector<int>> patterns(8, std::vector<int>(n));
+        for (int i = 0; i < n; ++i) {
+            patterns[0][i] = int(gen());                    // random
+            patterns[1][i] = i;                             // sorted
+            patterns[2][i] = n - i;                         // reversed
+            patterns[3][i] = 7;                             // all equal
+            patterns[4][i] = int(gen() % 8);                // few unique
+            patterns[5][i] = i < n / 2 ? i : n - i;         // organ pipe
+            patterns[6][i] = i % 1000;                      // sawtooth
+            patterns[7][i] = i;                             // sorted, random tail
+        }
+        for (int i = n - 100; i < n; ++i)
+            patterns[7][i] = int(gen() % n);
+        for (auto& v : patterns) {
+            std::vector<int> expected(v);
+            std::sort(expected.begin(), expected.end());
+            stl::sort(v.begin(), v.end());
+            assert(v == expected);
+        }
+
+        std::vector<double> dvec(n);
+        for (int i = 0; i < n; ++i)
+            dvec[i] = double(gen() % 1000) / 7;
+        stl::sort(dvec.begin(), dvec.end());
+        assert(std::is_sorted(dvec.begin(), dvec.end()));
+
+        std::vector<std::string> svec;
+        for (int i = 0; i < 2000; ++i)
+            svec.push_back(std::to_string(gen() % 500));
+        stl::sort(svec.begin(), svec.end());
+        assert(std::is_sorted(svec.begin(), svec.end()));
+        std::cout << "sort: 8 patterns, double and string keys passed" << std::endl << std::endl;
+    }
+
+    // Sort and select with a comparator
+    {
+        std::mt19937 gen(9);
+        std::vector<int> ivec(20000);
+        for (auto& x : ivec)
+            x = int(gen() % 5000);
+        std::vector<int> expected(ivec);
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+        stl::sort(ivec.begin(), ivec.end(), stl::greater<int>());
+        assert(ivec == expected);
+
+        struct point { int x, y; };
+        std::vector<point> pvec(5000);
+        for (auto& p : pvec)
+            p = point{int(gen() % 100), int(gen() % 100)};
+        auto by_y = [](const point& a, const point& b) { return a.y < b.y; };
+        stl::sort(pvec.begin(), pvec.end(), by_y);
+        assert(std::is_sorted(pvec.begin(), pvec.end(), by_y));
+
+        int ia[] = {5, 1, 9, 3, 7, 2, 8, 6, 4, 0};
+        stl::__insertion_sort(ia, ia + 10, stl::greater<int>());
+        assert(ia[0] == 9 && ia[9] == 0);
+        // depth limit 0: straight to the heapsort fallback
+        int ja[40];
+        for (int i = 0; i < 40; ++i)
+            ja[i] = (i * 17) % 40;
+        stl::__introsort_loop(ja, ja + 40, (int*)0, 0, stl::greater<int>());
+        assert(std::is_sorted(ja, ja + 40, std::greater<int>()));
+
+        stl::vector<int> nvec;
+        for (int i = 0; i < 1000; ++i)
+            nvec.push_back(i);
+        stl::random_shuffle(nvec.begin(), nvec.end());
+        stl::nth_element(nvec.begin(), nvec.begin() + 10, nvec.end(), stl::greater<int>());
+        assert(nvec[10] == 989);
+        for (int i = 0; i < 10; ++i)
+            assert(nvec[i] > 989);
+        std::cout << "sort, nth_element, insertion sort with comparators passed" << std::endl
+                  << std::endl;
+    }
+
+    // Radix sort
+    {
+        std::mt19937_64 gen(7);
+        for (int n : {0, 1, 100, 5000, 200000}) {
+            std::vector<unsigned> uvec(n);
+            std::vector<int> ivec(n);
+            std::vector<unsigned long> ulvec(n);
+            std::vector<long> lvec(n);
+            std::vector<float> fvec(n);
+            std::vector<double> dvec(n);
+            for (int i = 0; i < n; ++i) {
+                uvec[i] = unsigned(gen());
+                ivec[i] = int(gen() % 2001) - 1000;
+                ulvec[i] = gen() >> (i % 40);
+                lvec[i] = long(gen());
+                fvec[i] = float(int(gen() % 20001) - 10000) / 8;
+                dvec[i] = double(long(gen() % 2000001) - 1000000) * 1e-3;
+            }
+            auto check = [](auto v) {
+                auto expected = v;
+                std::sort(expected.begin(), expected.end());
+                stl::radix_sort(v.begin(), v.end());
+                assert(v == expected);
+                // sort() dispatches large arithmetic inputs to radix_sort
+                std::shuffle(v.begin(), v.end(), std::mt19937(1));
+                stl::sort(v.begin(), v.end());
+                assert(v == expected);
+            };
+            check(uvec);
+            check(ivec);
+            check(ulvec);
+            check(lvec);
+            check(fvec);
+            check(dvec);
+        }
+
+        // records by key: stable for keys up to 32 bits
+        struct record { int key; int seq; };
+        std::vector<record> rvec(50000);
+        for (int i = 0; i < 50000; ++i)
+            rvec[i] = record{int(gen() % 100) - 50, i};
+        stl::radix_sort(rvec.begin(), rvec.end(), [](const record& r) { return r.key; });
+        for (std::size_t i = 1; i < rvec.size(); ++i)
+            assert(rvec[i - 1].key < rvec[i].key
+                   || (rvec[i - 1].key == rvec[i].key && rvec[i - 1].seq < rvec[i].seq));
+
+        std::vector<std::string> svec;
+        for (int i = 0; i < 3000; ++i)
+            svec.push_back(std::string(gen() % 40, 'x'));
+        stl::radix_sort(svec.begin(), svec.end(), [](const std::string& s) { return s.size(); });
+        for (std::size_t i = 1; i < svec.size(); ++i)
+            assert(svec[i - 1].size() <= svec[i].size());
+        std::cout << "radix_sort: integer, float and keyed records passed" << std::endl << std::endl;
+    }
+
     // Equal range
-    // Inplace range
+    // Inplace merge
+    {
+        struct record { int key; int seq; };
+        auto by_key = [](const record& x, const record& y) { return x.key < y.key; };
+        auto stable = [](const record* first, const record* last) {
+            for (const record* i = first + 1; i < last; ++i)
+                if (i[-1].key > i->key || (i[-1].key == i->key && i[-1].seq > i->seq))
+                    return false;
+            return true;
+        };
+        std::mt19937 gen(3);
+        for (int n : {1, 2, 17, 1000, 50000}) {
+            std::vector<record> rvec(n);
+            int mid = int(gen() % n);
+            for (int i = 0; i < n; ++i)
+                rvec[i] = record{int(gen() % 50), i < mid ? i : i - n};
+            // both halves sorted by key; seq orders the left half before the right
+            std::sort(rvec.begin(), rvec.begin() + mid, [](const record& x, const record& y) {
+                return x.key < y.key || (x.key == y.key && x.seq < y.seq);
+            });
+            std::sort(rvec.begin() + mid, rvec.end(), [](const record& x, const record& y) {
+                return x.key < y.key || (x.key == y.key && x.seq < y.seq);
+            });
+            for (int i = mid; i < n; ++i)
+                rvec[i].seq += 2 * n;
+            std::vector<record> nobuf(rvec);
+            stl::inplace_merge(rvec.data(), rvec.data() + mid, rvec.data() + n, by_key);
+            assert(stable(rvec.data(), rvec.data() + n));
+            // the rotation-based merge, as if no buffer could be allocated
+            stl::__merge_adaptive(nobuf.data(), nobuf.data() + mid, nobuf.data() + n,
+                                  std::ptrdiff_t(mid), std::ptrdiff_t(n - mid),
+                                  (record*)0, std::ptrdiff_t(0), by_key);
+            assert(stable(nobuf.data(), nobuf.data() + n));
+        }
+
+        stl::list<int> ilist;
+        for (int i = 0; i < 10; ++i)
+            ilist.push_back(2 * i);
+        for (int i = 0; i < 10; ++i)
+            ilist.push_back(2 * i + 1);
+        auto ilist_mid = ilist.begin();
+        stl::advance(ilist_mid, 10);
+        stl::inplace_merge(ilist.begin(), ilist_mid, ilist.end());
+        std::cout << "inplace_merge(ilist): ";
+        ::print(ilist);
+        int expected = 0;
+        for (auto x : ilist)
+            assert(x == expected++);
+        std::cout << std::endl;
+
+        // the rotation-based merge on list iterators, as if no buffer could be allocated
+        std::vector<int> left(30), right(20);
+        for (auto& x : left)
+            x = int(gen() % 40);
+        for (auto& x : right)
+            x = int(gen() % 40);
+        std::sort(left.begin(), left.end());
+        std::sort(right.begin(), right.end());
+        stl::list<int> nobuf_list;
+        for (int x : left)
+            nobuf_list.push_back(x);
+        for (int x : right)
+            nobuf_list.push_back(x);
+        auto nobuf_mid = nobuf_list.begin();
+        stl::advance(nobuf_mid, 30);
+        stl::__merge_adaptive(nobuf_list.begin(), nobuf_mid, nobuf_list.end(),
+                              std::ptrdiff_t(30), std::ptrdiff_t(20),
+                              (int*)0, std::ptrdiff_t(0), stl::less<int>());
+        left.insert(left.end(), right.begin(), right.end());
+        std::sort(left.begin(), left.end());
+        auto merged = left.begin();
+        for (auto x : nobuf_list)
+            assert(x == *merged++);
+    }
+
+    // Stable sort
+    {
+        struct record { int key; int seq; };
+        std::mt19937 gen(5);
+        const int n = 100000;
+        std::vector<std::vector<int>> patterns(6, std::vector<int>(n));
+        for (int i = 0; i < n; ++i) {
+            patterns[0][i] = int(gen() % 1000);                     // random, duplicates
+            patterns[1][i] = i;                                     // sorted
+            patterns[2][i] = n - i;                                 // reversed
+            patterns[3][i] = (i / 5000) % 2 ? n - i : i;            // alternating runs
+            patterns[4][i] = i % 777;                               // sawtooth
+            patterns[5][i] = i < n - 50 ? i : int(gen() % n);       // sorted, random tail
+        }
+        for (auto& keys : patterns) {
+            std::vector<record> rvec(n);
+            for (int i = 0; i < n; ++i)
+                rvec[i] = record{keys[i], i};
+            stl::stable_sort(rvec.data(), rvec.data() + n,
+                             [](const record& x, const record& y) { return x.key < y.key; });
+            for (int i = 1; i < n; ++i)
+                assert(rvec[i - 1].key < rvec[i].key
+                       || (rvec[i - 1].key == rvec[i].key && rvec[i - 1].seq < rvec[i].seq));
+        }
+
+        std::vector<std::string> svec;
+        for (int i = 0; i < 5000; ++i)
+            svec.push_back(std::to_string(gen() % 3000));
+        std::vector<std::string> expected(svec);
+        std::stable_sort(expected.begin(), expected.end());
+        stl::stable_sort(svec.data(), svec.data() + svec.size());
+        assert(svec == expected);
+        std::cout << "stable_sort: 6 patterns and string keys passed" << std::endl << std::endl;
+    }
 
     // Nth element
     {
@@ -484,7 +931,58 @@ int main()
         assert(4 == *(ivec.begin() + 3));
         std::cout << "3rd element: " << *(ivec.begin() + 3)
                   << std::endl << std::endl;
+
+        // median-of-three killer: plain quickselect needs ~n^2/4 comparisons
+        const int n = 100000, k = n / 2;
+        std::vector<int> kvec(n);
+        for (int i = 1; i <= k; ++i) {
+            if (i % 2) {
+                kvec[i - 1] = i;
+                kvec[i] = k + i;
+            }
+            kvec[k + i - 1] = 2 * i;
+        }
+        long comparisons = 0;
+        auto counting_less = [&](int a, int b) { ++comparisons; return a < b; };
+        int* nth = kvec.data() + k;
+        stl::nth_element(kvec.data(), nth, kvec.data() + n, counting_less);
+        assert(*nth == k + 1);
+        assert(std::all_of(kvec.data(), nth, [&](int x) { return x <= *nth; }));
+        assert(std::all_of(nth, kvec.data() + n, [&](int x) { return x >= *nth; }));
+        assert(comparisons < 20L * n);
+
+        // many duplicates and every position of a small range
+        std::mt19937 gen(41);
+        std::vector<int> dvec(5000), sorted;
+        for (auto& x : dvec)
+            x = int(gen() % 7);
+        sorted = dvec;
+        std::sort(sorted.begin(), sorted.end());
+        for (int pos = 0; pos < 5000; pos += 499) {
+            std::vector<int> tmp(dvec);
+            stl::nth_element(tmp.data(), tmp.data() + pos, tmp.data() + tmp.size());
+            assert(tmp[pos] == sorted[pos]);
+        }
+        std::cout << "nth_element: killer sequence in " << comparisons / double(n)
+                  << " comparisons per element, duplicates passed" << std::endl << std::endl;
     }
 
     // Merge sort
+    {
+        std::mt19937 gen(11);
+        stl::list<int> ilist;
+        for (int i = 0; i < 1000; ++i)
+            ilist.push_back(int(gen() % 100));
+        stl::merge_sort(ilist.begin(), ilist.end());
+        for (auto i = ilist.begin(), j = ilist.begin(); ++j != ilist.end(); ++i)
+            assert(!(*j < *i));
+
+        int ia[] = {5, 3, 9, 1, 7, 2, 8};
+        stl::merge_sort(ia, ia + 7, stl::greater<int>());
+        std::cout << "merge_sort(ia, greater): ";
+        for (int x : ia)
+            std::cout << x << ", ";
+        std::cout << std::endl;
+        assert(ia[0] == 9 && ia[6] == 1);
+    }
 }
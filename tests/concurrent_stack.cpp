@@ -0,0 +1,65 @@
+#include "../concurrent_stack.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+int main()
+{
+    {
+        std::cout << "Single thread:" << std::endl;
+        stl::concurrent_stack<std::string> st;
+        assert(st.empty());
+        st.push("a");
+        st.emplace(2, 'b');
+        st.push(std::string("c"));
+        std::string s;
+        assert(st.try_pop(s) && s == "c");
+        assert(st.try_pop(s) && s == "bb");
+        st.push("d");
+        assert(st.try_pop(s) && s == "d");
+        assert(st.try_pop(s) && s == "a");
+        assert(!st.try_pop(s) && st.empty());
+        st.push("left behind");     // destroyed with the stack
+        std::cout << "  passed" << std::endl;
+    }
+
+    {
+        // Every thread pushes its own values and pops whatever is on top;
+        // heap-allocated strings make use-after-free visible to sanitizers.
+        const int threads = 8;
+        const long per_thread = 20000;
+        std::cout << "Stress, " << threads << " threads:" << std::endl;
+        stl::concurrent_stack<std::string> st;
+        std::atomic<long> popped_sum(0), popped(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                long sum = 0, count = 0;
+                std::string s;
+                for (long i = 0; i < per_thread; ++i) {
+                    st.push(std::string(40, 'x') + std::to_string(t * per_thread + i));
+                    if (i % 3 != 2 && st.try_pop(s)) {
+                        sum += std::stol(s.substr(40));
+                        ++count;
+                    }
+                }
+                popped_sum += sum;
+                popped += count;
+            });
+        for (auto& w : workers)
+            w.join();
+        std::string s;
+        while (st.try_pop(s)) {
+            popped_sum += std::stol(s.substr(40));
+            ++popped;
+        }
+        const long total = threads * per_thread;
+        assert(popped == total && popped_sum == total * (total - 1) / 2);
+        std::cout << "  " << total << " elements pushed and popped exactly once" << std::endl;
+    }
+
+    return 0;
+}
@@ -1,6 +1,16 @@
 #include "../deque.hpp"
+#include "../algorithm.hpp"
+#include "../numeric.hpp"
+#include "../vector.hpp"
 #include <algorithm>
+#include <numeric>
+#include <deque>
+#include <utility>
 #include <iostream>
+#include <cassert>
+#include <vector>
+#include <sstream>
+#include <iterator>
 #include "../memory/alloc.hpp"
 
 template<typename T, typename Alloc, std::size_t BufSiz>
@@ -49,10 +59,10 @@ int main()
 #ifdef STL_IMPL_ALGORITHM_
     auto fnd = stl::find(ideq.begin(), ideq.end(), 99);
     std::cout << "Find 99 in `ideq`:" << std::endl;
-    std::cout << "*itr = " << *itr << std::endl;
-    std::cout << "*(itr.cur) = " << *(itr.cur) << std::endl;
+    std::cout << "*fnd = " << *fnd << std::endl;
+    std::cout << "*(fnd.cur) = " << *(fnd.cur) << std::endl;
 
-    ideq.erase(itr);
+    ideq.erase(fnd);
     std::cout << "Erase found one:" << std::endl;
     print_deque_info(ideq);
 #endif /* STL_IMPL_ALGORITHM_ */
@@ -88,5 +98,164 @@ int main()
         print_deque_info(ideq);
     }
 
+    {
+        std::cout << "FIFO crossing block boundaries (spare-block cache):" << std::endl;
+        stl::deque<int, stl::alloc, 8> ideq;
+        int next_in = 0, next_out = 0;
+        for (int round = 0; round < 1000; ++round) {
+            for (int i = 0; i < 5; ++i)
+                ideq.push_back(next_in++);
+            for (int i = 0; i < 5; ++i) {
+                assert(ideq.front() == next_out);
+                ++next_out;
+                ideq.pop_front();
+            }
+        }
+        assert(ideq.empty());
+        for (int i = 0; i < 20; ++i)
+            ideq.push_front(i);
+        for (int i = 0; i < 20; ++i) {
+            assert(ideq.back() == i);
+            ideq.pop_back();
+        }
+        assert(ideq.empty());
+        std::cout << "  " << next_out << " elements passed through" << std::endl;
+
+        for (int i = 0; i < 20; ++i)
+            ideq.push_back(i);
+        stl::deque<int, stl::alloc, 8> copied(ideq);
+        ideq.erase(ideq.begin(), ideq.begin() + 17);
+        assert(ideq.size() == 3 && ideq.front() == 17);
+        assert(copied.size() == 20 && copied.back() == 19);
+        copied = ideq;
+        assert(copied.size() == 3 && copied.front() == 17);
+        print_deque_info(copied);
+    }
+
+    {
+        std::cout << "Segmented algorithms over block boundaries:" << std::endl;
+        stl::deque<int, stl::alloc, 8> ideq;
+        for (int i = 0; i < 50; ++i)
+            ideq.push_back(i);
+        for (int i = 1; i <= 3; ++i)
+            ideq.push_front(-i);    // start in the middle of a block
+
+        auto first = ideq.begin() + 2, last = ideq.end() - 3;
+        assert(stl::accumulate(ideq.begin(), ideq.end(), 0) == 1225 - 6);
+        assert(stl::accumulate(first, last, 0) == std::accumulate(first, last, 0));
+        assert(stl::accumulate(first, first + 1, 0) == -1);
+        assert(stl::find(ideq.begin(), ideq.end(), 41) - ideq.begin() == 44);
+        assert(stl::find(first, last, 48) == last);
+        assert(stl::find(first, first, -1) == first);
+
+        int sum = 0;
+        stl::for_each(first, last, [&sum](int x) { sum += x; });
+        assert(sum == std::accumulate(first, last, 0));
+
+        stl::vector<int> ivec(ideq.size());
+        stl::copy(ideq.begin(), ideq.end(), ivec.begin());
+        assert(std::equal(ivec.begin(), ivec.end(), ideq.begin()));
+
+        stl::deque<int, stl::alloc, 8> other(ideq.size() + 5, 0);
+        auto out = stl::copy(ideq.begin(), ideq.end(), other.begin() + 3);
+        assert(out == other.begin() + 3 + ideq.size());
+        assert(std::equal(ideq.begin(), ideq.end(), other.begin() + 3));
+        out = stl::copy(ivec.begin() + 1, ivec.begin() + 9, other.begin() + 5);
+        assert(out == other.begin() + 13 && other[12] == ivec[8]);
+
+        stl::fill(first, last, 7);
+        assert(ideq[1] == -2 && ideq[2] == 7 && ideq[ideq.size() - 4] == 7);
+        assert(ideq.back() == 49);
+        print_deque_info(ideq);
+    }
+
+    {
+        std::cout << "Bulk insert against std::deque:" << std::endl;
+        stl::deque<int, stl::alloc, 8> ideq;
+        std::deque<int> model;
+        int ia[37];
+        for (int i = 0; i < 37; ++i)
+            ia[i] = 1000 + i;
+        for (int i = 0; i < 30; ++i) {
+            ideq.push_back(i);
+            model.push_back(i);
+        }
+        // front, back, both halves, gaps shorter and longer than the moved side
+        const int positions[] = {0, 30, 1, 3, 28, 12, 20, 40, 5};
+        const int counts[]    = {5,  9, 13, 2, 17, 37,  1,  8, 0};
+        for (int k = 0; k < 9; ++k) {
+            int pos = positions[k] < int(model.size()) ? positions[k] : int(model.size());
+            ideq.insert(ideq.begin() + pos, counts[k], -k);
+            model.insert(model.begin() + pos, counts[k], -k);
+            assert(ideq.size() == model.size());
+            assert(std::equal(model.begin(), model.end(), ideq.begin()));
+
+            ideq.insert(ideq.begin() + pos, ia, ia + counts[k]);
+            model.insert(model.begin() + pos, ia, ia + counts[k]);
+            assert(ideq.size() == model.size());
+            assert(std::equal(model.begin(), model.end(), ideq.begin()));
+        }
+        std::cout << "  size=" << ideq.size() << std::endl;
+
+        stl::deque<int, stl::alloc, 8> ranged(ia, ia + 37);
+        assert(ranged.size() == 37 && ranged[36] == 1036);
+
+        stl::deque<int, stl::alloc, 8> moved(std::move(ranged));
+        assert(moved.size() == 37 && ranged.empty());
+        ranged.push_back(1);
+        ranged = std::move(moved);
+        assert(ranged.size() == 37 && ranged.front() == 1000 && moved.empty());
+
+        stl::deque<std::pair<int, int>, stl::alloc, 8> pdeq;
+        for (int i = 0; i < 10; ++i) {
+            pdeq.emplace_back(i, i * i);
+            pdeq.emplace_front(-i, i);
+        }
+        assert(pdeq.size() == 20);
+        assert(pdeq.front().first == -9 && pdeq.back().second == 81);
+        std::cout << std::endl;
+    }
+
+    {
+        std::cout << "Per-instance buffer size:" << std::endl;
+        stl::deque<int> ideq(stl::deque_buffer_size(4));
+        assert(ideq.buffer_size() == 4 && ideq.empty());
+        for (int i = 0; i < 30; ++i)
+            ideq.push_back(i);
+        for (int i = 1; i <= 5; ++i)
+            ideq.push_front(-i);
+        assert(ideq[0] == -5 && ideq[5] == 0 && ideq[34] == 29);
+        assert((ideq.end() - ideq.begin()) == 35);
+        assert(*(ideq.begin() + 17) == 12 && *(ideq.end() - 9) == 21);
+        assert(stl::accumulate(ideq.begin(), ideq.end(), 0) == 435 - 15);
+        stl::deque<int> copied(ideq);
+        assert(copied.buffer_size() == 4 && copied.size() == 35);
+        ideq.insert(ideq.begin() + 7, 10, 42);
+        assert(ideq.size() == 45 && ideq[16] == 42 && ideq[17] == 2);
+        ideq.insert(ideq.begin(), 3u, 1);
+        ideq.insert(ideq.end(), 2L, 7);
+        assert(ideq.size() == 50 && ideq[2] == 1 && ideq[3] == -5 && ideq[49] == 7);
+
+        // ranges of std iterators: random access, and input only
+        std::vector<int> sv = {1, 2, 3, 4, 5};
+        stl::deque<int> from_std(sv.begin(), sv.end());
+        assert(from_std.size() == 5 && from_std[4] == 5);
+        from_std.insert(from_std.begin() + 2, sv.begin(), sv.end());
+        assert(from_std.size() == 10 && from_std[2] == 1 && from_std[6] == 5 && from_std[7] == 3);
+        std::istringstream in("8 9");
+        from_std.insert(from_std.end(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+        assert(from_std.size() == 12 && from_std[11] == 9);
+        stl::deque<unsigned> filled(4u, 6u);
+        assert(filled.size() == 4 && filled[3] == 6);
+
+        struct wide { char bytes[1000]; };
+        assert(stl::deque<wide>().buffer_size() >= 8);
+        assert(stl::deque<int>().buffer_size() == 128);
+        std::cout << "  default buffer sizes: char " << stl::deque<char>().buffer_size()
+                  << ", int " << stl::deque<int>().buffer_size()
+                  << ", 1000-byte struct " << stl::deque<wide>().buffer_size() << std::endl;
+        print_deque_info(ideq);
+    }
+
     return 0;
 }
\ No newline at end of file
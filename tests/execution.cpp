@@ -0,0 +1,157 @@
+#include "../execution.hpp"
+#include "../vector.hpp"
+#include "../list.hpp"
+#include "../deque.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <random>
+
+template<typename Policy>
+static void check_algorithms(const Policy& policy, const char* name)
+{
+    std::cout << name << ":" << std::endl;
+    const int n = 300000;
+    stl::vector<int> v(n, 0);
+    for (int i = 0; i < n; ++i)
+        v[i] = i;
+
+    std::atomic<long> sum(0);
+    stl::for_each(policy, v.begin(), v.end(), [&sum](int x) { sum += x; });
+    assert(sum == long(n) * (n - 1) / 2);
+
+    assert(stl::count_if(policy, v.begin(), v.end(), [](int x) { return x % 3 == 0; }) == n / 3);
+
+    auto is_big = [](int x) { return x >= 123457; };
+    assert(stl::find_if(policy, v.begin(), v.end(), is_big) - v.begin() == 123457);
+    assert(stl::find_if(policy, v.begin(), v.end(), [](int x) { return x < 0; }) == v.end());
+    // the first match wins even if a later block finds one sooner
+    v[250000] = -1;
+    v[7] = -2;
+    assert(stl::find_if(policy, v.begin(), v.end(), [](int x) { return x < 0; }) - v.begin() == 7);
+    v[250000] = 250000;
+    v[7] = 7;
+
+    stl::vector<long> w(n, 0L);
+    assert(stl::transform(policy, v.begin(), v.end(), w.begin(),
+                          [](int x) { return 2L * x; }) == w.end());
+    assert(w[0] == 0 && w[n - 1] == 2L * (n - 1));
+    stl::transform(policy, v.begin(), v.end(), w.begin(), w.begin(),
+                   [](int x, long y) { return x + y; });
+    assert(w[1000] == 3000 && w[n - 1] == 3L * (n - 1));
+
+    assert(stl::reduce(policy, w.begin(), w.end()) == 3L * n * (n - 1) / 2);
+    assert(stl::reduce(policy, v.begin(), v.end(), 10L) == 10L + long(n) * (n - 1) / 2);
+    assert(stl::reduce(policy, v.begin(), v.begin() + 20, 1L,
+                       [](long a, long b) { return a > b ? a : b; }) == 19);
+
+    stl::fill(policy, v.begin() + 10, v.end() - 10, 5);
+    assert(v[9] == 9 && v[10] == 5 && v[n - 11] == 5 && v[n - 10] == n - 10);
+
+    stl::vector<int> c(n, 0);
+    assert(stl::copy(policy, v.begin(), v.end(), c.begin()) == c.end());
+    assert(c[9] == 9 && c[n / 2] == 5 && c[n - 1] == n - 1);
+    // the same blocks with streaming stores, from a misaligned source
+    std::size_t threshold = stl::__simd_stream_threshold();
+    stl::__simd_stream_threshold() = 0;
+    const int* src = v.begin();
+    assert(stl::copy(policy, src + 1, src + n - 2, c.begin() + 3) == c.begin() + n);
+    stl::__simd_stream_threshold() = threshold;
+    for (int i = 1; i < n - 2; ++i)
+        assert(c[i + 2] == v[i]);
+
+    // deque iterators are random access too
+    stl::deque<int> d;
+    for (int i = 0; i < 5000; ++i)
+        d.push_back(i);
+    assert(stl::reduce(policy, d.begin(), d.end(), 0L) == 5000L * 4999 / 2);
+
+    // a list is not: the sequential algorithm runs
+    stl::list<int> l;
+    for (int i = 0; i < 100; ++i)
+        l.push_back(i);
+    assert(stl::count_if(policy, l.begin(), l.end(), [](int x) { return x < 10; }) == 10);
+    stl::fill(policy, l.begin(), l.end(), 1);
+    assert(stl::reduce(policy, l.begin(), l.end()) == 100);
+    std::cout << "  passed" << std::endl;
+}
+
+template<typename Policy>
+static void check_sort(const Policy& policy, const char* name)
+{
+    std::cout << "sort, " << name << ":" << std::endl;
+    std::mt19937 gen(42);
+    const int n = 400000;
+    for (int pattern = 0; pattern < 5; ++pattern) {
+        stl::vector<int> v(n, 0);
+        for (int i = 0; i < n; ++i) {
+            switch (pattern) {
+            case 0: v[i] = int(gen()); break;          // random
+            case 1: v[i] = int(gen() % 4); break;      // few distinct keys
+            case 2: v[i] = i; break;                   // sorted
+            case 3: v[i] = n - i; break;               // reversed
+            default: v[i] = 7; break;                  // all equal
+            }
+        }
+        long sum = stl::accumulate(v.begin(), v.end(), 0L);
+        stl::sort(policy, v.begin(), v.end());
+        for (int i = 1; i < n; ++i)
+            assert(!(v[i] < v[i - 1]));
+        assert(stl::accumulate(v.begin(), v.end(), 0L) == sum);
+    }
+    stl::deque<double> d;
+    for (int i = 0; i < 100000; ++i)
+        d.push_back(double(gen() % 1000) / 7);
+    stl::sort(policy, d.begin(), d.end());
+    for (int i = 1; i < 100000; ++i)
+        assert(!(d[i] < d[i - 1]));
+
+    stl::vector<int> w(n, 0);
+    for (int i = 0; i < n; ++i)
+        w[i] = int(gen() % 100000);
+    stl::sort(policy, w.begin(), w.end(), stl::greater<int>());
+    for (int i = 1; i < n; ++i)
+        assert(!(w[i - 1] < w[i]));
+    std::cout << "  passed" << std::endl;
+}
+
+int main()
+{
+    check_algorithms(stl::execution::seq, "seq");
+    check_algorithms(stl::execution::par, "par, default pool");
+    check_algorithms(stl::execution::par_unseq, "par_unseq, default pool");
+
+    {
+        // small blocks on a pool wider than this machine, so the stealing
+        // paths are exercised even on one core
+        stl::thread_pool pool(3);
+        check_algorithms(stl::execution::par.on(pool).grain_size(1000), "par, 3 workers, grain 1000");
+        check_algorithms(stl::execution::par_unseq.on(pool).grain_size(7), "par_unseq, 3 workers, grain 7");
+
+        std::cout << "nested parallel_for:" << std::endl;
+        std::atomic<long> cells(0);
+        pool.parallel_for(64, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; ++i)
+                pool.parallel_for(100, 10, [&](std::size_t a, std::size_t b) {
+                    cells += long(b - a);
+                });
+        });
+        assert(cells == 6400);
+        std::cout << "  passed" << std::endl;
+
+        check_sort(stl::execution::par.on(pool), "3 workers");
+    }
+    check_sort(stl::execution::seq, "seq");
+    check_sort(stl::execution::par, "default pool");
+
+    {
+        std::cout << "pool without workers:" << std::endl;
+        stl::thread_pool pool(0);
+        assert(pool.concurrency() == 1);
+        stl::vector<int> v(10000, 1);
+        assert(stl::reduce(stl::execution::par.on(pool).grain_size(10), v.begin(), v.end()) == 10000);
+        std::cout << "  passed" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "../mpmc_queue.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+
+// moves construct without throwing, but assigning to a "bad" target throws
+struct picky {
+    long v;
+    bool bad;
+    picky(long x = 0, bool b = false) : v(x), bad(b) {}
+    picky(picky&& y) noexcept : v(y.v), bad(false) {}
+    picky& operator=(picky&& y) {
+        if (bad) throw 1;
+        v = y.v;
+        return *this;
+    }
+};
+
+template<typename Queue>
+static void run_threads(Queue& q, int producers, int consumers, long per_producer)
+{
+    std::atomic<long> sum(0), count(0);
+    std::thread* threads[16];
+    int nthreads = 0;
+    for (int p = 0; p < producers; ++p)
+        threads[nthreads++] = new std::thread([&q, p, per_producer] {
+            long batch[8];
+            for (long i = 0; i < per_producer; ) {
+                long v = p * per_producer + i;
+                if (i % 5 == 0) {
+                    q.push(v);
+                    ++i;
+                } else {
+                    long k = 0;
+                    for (; k < 8 && i + k < per_producer; ++k)
+                        batch[k] = v + k;
+                    long pushed = q.try_push(batch, batch + k) - batch;
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    i += pushed;
+                }
+            }
+        });
+    const long total = producers * per_producer;
+    for (int c = 0; c < consumers; ++c)
+        threads[nthreads++] = new std::thread([&q, &sum, &count, c, total] {
+            long out[8];
+            long local = 0;
+            for (;;) {
+                long k;
+                if (c % 2) {
+                    long x;
+                    k = q.try_pop(x) ? 1 : 0;
+                    if (k) local += x;
+                } else {
+                    k = long(q.try_pop(out, 8));
+                    for (long j = 0; j < k; ++j)
+                        local += out[j];
+                }
+                if (k == 0) {
+                    if (count.load() >= total)
+                        break;
+                    std::this_thread::yield();
+                } else {
+                    count += k;
+                }
+            }
+            sum += local;
+        });
+    for (int i = 0; i < nthreads; ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+    assert(count == total && sum == total * (total - 1) / 2);
+    assert(q.empty());
+}
+
+int main()
+{
+    {
+        std::cout << "Single thread:" << std::endl;
+        stl::mpmc_queue<std::string> q(3);
+        assert(q.capacity() == 4 && q.empty());
+        assert(q.try_push("a") && q.try_emplace(2, 'b') && q.try_push("c") && q.try_push("d"));
+        assert(!q.try_push("e") && q.size() == 4);
+        std::string s;
+        assert(q.try_pop(s) && s == "a");
+
+        std::string in[] = {"e", "f", "g"};
+        assert(q.try_push(in, in + 3) == in + 1);
+        std::string out[8];
+        assert(q.try_pop(out, 8) == 4);
+        assert(out[0] == "bb" && out[3] == "e");
+        assert(q.empty() && !q.try_pop(s));
+        q.push("left behind");      // destroyed with the queue
+        bool thrown = false;
+        try {
+            stl::mpmc_queue<int> huge(std::size_t(-1));
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        std::cout << "  passed" << std::endl;
+    }
+
+    {
+        std::cout << "A throwing assignment on pop releases the cell:" << std::endl;
+        stl::mpmc_queue<picky> q(2);
+        picky bad(-1, true);
+        picky outs[2] = {picky(-1), picky(-1, true)};
+        for (int round = 0; round < 3; ++round) {
+            assert(q.try_push(picky(1)) && q.try_push(picky(2)));
+            bool threw = false;
+            try { q.try_pop(bad); } catch (int) { threw = true; }
+            assert(threw && q.size() == 1);
+            assert(q.try_push(picky(3)));          // the slot wrapped to is free
+            threw = false;
+            try { q.try_pop(outs, 2); } catch (int) { threw = true; }
+            assert(threw && outs[0].v == 2 && q.empty());
+        }
+        std::cout << "  passed" << std::endl;
+    }
+
+    {
+        std::cout << "4 producers, 4 consumers:" << std::endl;
+        stl::mpmc_queue<long> q(64);
+        run_threads(q, 4, 4, 100000);
+        std::cout << "  passed" << std::endl;
+    }
+
+    {
+        std::cout << "Blocking mode, 3 producers, 2 consumers:" << std::endl;
+        stl::mpmc_queue<long, stl::alloc, true> q(8);
+        run_threads(q, 3, 2, 50000);
+
+        // a consumer asleep on an empty queue is woken by a push
+        long got = -1;
+        std::thread consumer([&] { q.pop(got); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        q.push(42);
+        consumer.join();
+        assert(got == 42);
+
+        // and a producer asleep on a full queue by a pop
+        for (long i = 0; i < 8; ++i)
+            q.push(i);
+        std::thread producer([&] { q.push(8); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        long x;
+        q.pop(x);
+        producer.join();
+        assert(x == 0 && q.size() == 8);
+        std::cout << "  passed" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "../ring_buffer.hpp"
+#include "../queue.hpp"
+#include "../stack.hpp"
+#include "../algorithm.hpp"
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+template<typename RingBuffer>
+static void print_ring_buffer_info(RingBuffer& rb)
+{
+    std::cout << "  size=" << rb.size() << ", capacity=" << rb.capacity() << std::endl << "  content:";
+    for (auto itr = rb.begin(); itr != rb.end(); ++itr)
+        std::cout << " " << *itr;
+    if (rb.empty()) std::cout << " (null)";
+    auto one = rb.array_one(), two = rb.array_two();
+    std::cout << std::endl << "  spans: " << one.second << " + " << two.second
+              << std::endl << std::endl;
+}
+
+int main()
+{
+    {
+        std::cout << "ctor(5) rounds up to a power of two:" << std::endl;
+        stl::ring_buffer<int> rb(5);
+        assert(rb.capacity() == 8 && rb.empty());
+        for (int i = 0; i < 6; ++i)
+            rb.push_back(i);
+        for (int i = 0; i < 4; ++i)
+            rb.pop_front();
+        for (int i = 6; i < 12; ++i)
+            rb.push_back(i);    // wraps around
+        assert(rb.full() && rb.front() == 4 && rb.back() == 11);
+        assert(rb[3] == 7 && *(rb.begin() + 5) == 9 && rb.end() - rb.begin() == 8);
+        auto one = rb.array_one(), two = rb.array_two();
+        assert(one.second + two.second == 8 && *one.first == 4 && *two.first == 8);
+        print_ring_buffer_info(rb);
+
+        bool thrown = false;
+        try {
+            rb.push_back(12);
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown && rb.size() == 8);
+        thrown = false;
+        try {
+            stl::ring_buffer<int> huge(std::size_t(-1));
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        const std::size_t top = ~(std::size_t(-1) >> 1);
+        assert(thrown && stl::__ring_buffer_capacity(top) == top);
+
+        rb.pop_back();          // make room at the front
+        rb.push_front(3);
+        assert(rb.front() == 3 && rb.back() == 10);
+        stl::sort(rb.begin(), rb.end());
+        assert(rb.front() == 3 && rb[7] == 10);
+        assert(stl::find(rb.begin(), rb.end(), 8) - rb.begin() == 5);
+    }
+
+    {
+        std::cout << "Overwrite on full:" << std::endl;
+        stl::ring_buffer<int, stl::alloc, true> rb(4);
+        for (int i = 0; i < 10; ++i)
+            rb.push_back(i);
+        assert(rb.size() == 4 && rb.front() == 6 && rb.back() == 9);
+        rb.push_front(-1);
+        assert(rb.front() == -1 && rb.back() == 8);
+        print_ring_buffer_info(rb);
+
+        int ia[] = {100, 101, 102, 103, 104, 105};
+        rb.push_back(ia, ia + 3);
+        assert(rb.size() == 4 && rb.front() == 8 && rb.back() == 102);
+        rb.push_back(ia, ia + 6);
+        assert(rb.front() == 102 && rb.back() == 105);
+        rb.pop_front(3);
+        assert(rb.size() == 1 && rb.front() == 105);
+        print_ring_buffer_info(rb);
+    }
+
+    {
+        std::cout << "Non-trivial elements, copy and move:" << std::endl;
+        stl::ring_buffer<std::string> rb(4);
+        rb.push_back("b");
+        rb.push_front("a");
+        rb.emplace_back(3, 'c');
+        stl::ring_buffer<std::string> copied(rb);
+        stl::ring_buffer<std::string> moved(std::move(rb));
+        assert(rb.empty() && moved.size() == 3 && copied.back() == "ccc");
+        moved.pop_front(2);
+        assert(moved.front() == "ccc");
+        print_ring_buffer_info(copied);
+    }
+
+    {
+        std::cout << "As the Sequence of queue and stack:" << std::endl;
+        stl::queue<int, stl::ring_buffer<int>> iqueue(stl::ring_buffer<int>(16));
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 10; ++i)
+                iqueue.push(round * 10 + i);
+            for (int i = 0; i < 10; ++i) {
+                assert(iqueue.front() == round * 10 + i);
+                iqueue.pop();
+            }
+        }
+        assert(iqueue.empty());
+
+        stl::stack<int, stl::ring_buffer<int>> istack;
+        for (int i = 0; i < 6; ++i)
+            istack.push(i);
+        assert(istack.size() == 6 && istack.top() == 5);
+        istack.pop();
+        assert(istack.top() == 4);
+        std::cout << "  passed" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "../searcher.hpp"
+#include "../algorithm.hpp"
+#include "../vector.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+// Both searchers and stl::search against std::search over random texts from
+// an alphabet of k letters, where small k gives periodic patterns and many
+// partial matches
+template<typename T>
+static void check_against_std(std::mt19937& gen, int k)
+{
+    std::vector<T> text(600), pattern;
+    for (auto& x : text)
+        x = T('a' + gen() % k);
+    for (std::size_t m = 0; m <= 40; m += m < 12 ? 1 : 7) {
+        for (int trial = 0; trial < 6; ++trial) {
+            pattern.clear();
+            if (trial % 2) {            // a piece of the text: found
+                std::size_t at = gen() % (text.size() - m);
+                pattern.assign(text.begin() + at, text.begin() + at + m);
+            }
+            else {
+                for (std::size_t i = 0; i < m; ++i)
+                    pattern.push_back(T('a' + gen() % k));
+            }
+            const T* p = pattern.data();
+            stl::boyer_moore_horspool_searcher<const T*> bmh(p, p + m);
+            stl::two_way_searcher<const T*> two_way(p, p + m);
+            for (std::size_t len : {std::size_t(0), m, m + 33, text.size()}) {
+                if (len > text.size()) continue;
+                const T* first = text.data();
+                const T* last = first + len;
+                const T* expected = std::search(first, last, p, p + m);
+                auto r1 = bmh(first, last);
+                auto r2 = two_way(first, last);
+                assert(r1.first == expected && r2.first == expected);
+                assert(r1.second == (expected == last ? last : expected + m));
+                assert(r2.second == r1.second);
+                assert(stl::search(first, last, bmh) == expected);
+                assert(stl::search(first, last, p, p + m) == expected);
+            }
+        }
+    }
+}
+
+// an element that counts its equality tests
+static long equality_tests = 0;
+struct counted {
+    int x;
+    bool operator==(const counted& y) const { ++equality_tests; return x == y.x; }
+    bool operator<(const counted& y) const { return x < y.x; }
+};
+
+int main()
+{
+    {
+        std::cout << "boyer_moore_horspool_searcher, two_way_searcher against std::search:"
+                  << std::endl;
+        std::mt19937 gen(50);
+        for (int level = stl::__simd_scalar; level <= stl::__simd_avx2; ++level) {
+            stl::__simd_max_level() = level;
+            for (int k : {1, 2, 4, 26}) {
+                check_against_std<char>(gen, k);
+                check_against_std<unsigned char>(gen, k);
+                check_against_std<int>(gen, k);
+            }
+        }
+        stl::__simd_max_level() = stl::__simd_avx2;
+        std::cout << "  passed" << std::endl << std::endl;
+    }
+
+    {
+        std::cout << "One searcher over many haystacks, other iterators and predicates:"
+                  << std::endl;
+        const std::string needle = "ERROR";
+        stl::boyer_moore_horspool_searcher<std::string::const_iterator>
+            bmh(needle.begin(), needle.end());
+        stl::two_way_searcher<const char*> two_way(needle.data(), needle.data() + needle.size());
+        const char* lines[] = {"INFO start", "WARN disk 91%", "ERROR timeout", "xERRORERROR", "ERRO"};
+        const long at[] = {-1, -1, 0, 1, -1};
+        for (int i = 0; i < 5; ++i) {
+            std::string line = lines[i];
+            auto r = bmh(line.begin(), line.end());
+            long expect = at[i] < 0 ? long(line.size()) : at[i];
+            assert(r.first - line.begin() == expect);
+            const char* s = line.data();
+            assert(stl::search(s, s + line.size(), two_way) - s == expect);
+        }
+
+        // elements of an stl container, found at the expected spot
+        stl::vector<int> hay;
+        for (int i = 0; i < 1000; ++i)
+            hay.push_back(i % 17);
+        int pattern[] = {15, 16, 0, 1};
+        stl::two_way_searcher<int*> ints(pattern, pattern + 4);
+        auto r = ints(hay.begin(), hay.end());
+        assert(r.first - hay.begin() == 15 && r.second - r.first == 4);
+
+        // a case-insensitive predicate and a hash consistent with it
+        struct nocase_hash {
+            std::size_t operator()(char c) const { return std::size_t(std::tolower(c)); }
+        };
+        struct nocase_equal {
+            bool operator()(char a, char b) const { return std::tolower(a) == std::tolower(b); }
+        };
+        const char pat[] = "TimeOut";
+        stl::boyer_moore_horspool_searcher<const char*, nocase_hash, nocase_equal>
+            nocase(pat, pat + 7);
+        std::string line = "request timed out after TIMEOUT";
+        auto n = nocase(line.begin(), line.end());
+        assert(n.first - line.begin() == 24 && n.second - n.first == 7);
+        std::cout << "  passed" << std::endl << std::endl;
+    }
+
+    {
+        std::cout << "two_way_searcher is linear where the naive scan is O(n m):" << std::endl;
+        const int n = 100000, m = 1000;
+        std::vector<counted> text(n, counted{0}), pattern(m, counted{0});
+        pattern[m - 1].x = 1;                         // a^(m-1) b in a^n: never found
+        stl::two_way_searcher<const counted*> two_way(pattern.data(), pattern.data() + m);
+        equality_tests = 0;
+        assert(two_way(text.data(), text.data() + n).first == text.data() + n);
+        assert(equality_tests < 3L * n);
+        pattern[m - 1].x = 0;                         // a^m in (a^(m-1) b)^*: periodic
+        for (int i = m - 1; i < n; i += m)
+            text[i].x = 1;
+        stl::two_way_searcher<const counted*> periodic(pattern.data(), pattern.data() + m);
+        equality_tests = 0;
+        assert(periodic(text.data(), text.data() + n).first == text.data() + n);
+        assert(equality_tests < 3L * n);
+        text.insert(text.end(), m, counted{0});       // ... a^(m-1) b a^m
+        assert(periodic(text.data(), text.data() + text.size()).first == text.data() + n);
+        std::cout << "  passed" << std::endl << std::endl;
+    }
+
+    {
+        std::cout << "find_end finds the last occurrence:" << std::endl;
+        std::mt19937 gen(51);
+        std::vector<int> text(300);
+        for (auto& x : text)
+            x = int(gen() % 3);
+        for (std::size_t m = 0; m <= 6; ++m) {
+            std::vector<int> pattern(text.begin() + 100, text.begin() + 100 + m);
+            const int* first = text.data();
+            const int* last = first + text.size();
+            assert(stl::find_end(first, last, pattern.data(), pattern.data() + m)
+                   == std::find_end(first, last, pattern.data(), pattern.data() + m));
+        }
+        std::cout << "  passed" << std::endl;
+    }
+
+    return 0;
+}
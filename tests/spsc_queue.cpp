@@ -0,0 +1,76 @@
+#include "../spsc_queue.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+
+int main()
+{
+    {
+        std::cout << "Single thread:" << std::endl;
+        stl::spsc_queue<std::string> q(3);
+        assert(q.capacity() == 4 && q.empty());
+        assert(q.try_push("a") && q.try_push("b") && q.try_emplace(2, 'c') && q.try_push("d"));
+        assert(!q.try_push("e") && q.size() == 4);
+        assert(q.front() == "a");
+        q.pop();
+        std::string s;
+        assert(q.try_pop(s) && s == "b");
+        std::cout << "  front after two pops: " << q.front() << std::endl;
+
+        std::string in[] = {"e", "f", "g", "h"};
+        std::string* rest = q.try_push(in, in + 4);     // room for two only
+        assert(rest == in + 2 && q.size() == 4);
+
+        std::string out[8];
+        assert(q.try_pop(out, 8) == 4);
+        assert(out[0] == "cc" && out[1] == "d" && out[2] == "e" && out[3] == "f");
+        assert(q.empty() && !q.try_pop(s));
+
+        q.push("left behind");      // destroyed with the queue
+    }
+
+    {
+        std::cout << "Producer/consumer threads:" << std::endl;
+        const long n = 1000000;
+        stl::spsc_queue<long> q(64);
+        std::thread producer([&] {
+            long batch[16];
+            for (long i = 0; i < n; ) {
+                if (i % 3 == 0) {
+                    q.push(i++);
+                } else {
+                    long k = 0;
+                    for (; k < 16 && i + k < n; ++k)
+                        batch[k] = i + k;
+                    long pushed = q.try_push(batch, batch + k) - batch;
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    i += pushed;
+                }
+            }
+        });
+        long expect = 0;
+        long buf[32];
+        while (expect < n) {
+            if (expect % 2) {
+                long x;
+                if (q.try_pop(x))
+                    assert(x == expect++);
+                else
+                    std::this_thread::yield();
+            } else {
+                stl::spsc_queue<long>::size_type k = q.try_pop(buf, 32);
+                for (stl::spsc_queue<long>::size_type j = 0; j < k; ++j)
+                    assert(buf[j] == expect++);
+                if (k == 0)
+                    std::this_thread::yield();
+            }
+        }
+        producer.join();
+        assert(q.empty());
+        std::cout << "  " << n << " elements received in order" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "../static_search_index.hpp"
+#include "../algorithm.hpp"
+#include "../vector.hpp"
+#include <iostream>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <string>
+
+int main()
+{
+    {
+        std::cout << "static_search_index<int> against stl::lower_bound:" << std::endl;
+        // every size up to 70 covers complete and ragged last levels
+        for (int n = 0; n <= 70; ++n) {
+            stl::vector<int> sorted;
+            for (int i = 0; i < n; ++i)
+                sorted.push_back(2 * (i / 2));     // pairs of duplicates
+            stl::static_search_index<int> index(sorted);
+            assert(index.size() == std::size_t(n) && index.empty() == (n == 0));
+            for (int x = -1; x <= n + 1; ++x) {
+                std::size_t expected = stl::lower_bound(sorted.begin(), sorted.end(), x)
+                                     - sorted.begin();
+                assert(index.lower_bound(x) == expected);
+                assert(index.contains(x) == stl::binary_search(sorted.begin(), sorted.end(), x));
+            }
+        }
+
+        std::mt19937 gen(44);
+        stl::vector<int> sorted;
+        for (int i = 0; i < 100000; ++i)
+            sorted.push_back(int(gen() % 1000000));
+        stl::sort(sorted.begin(), sorted.end());
+        stl::static_search_index<int> index(sorted);
+        for (int i = 0; i < 100000; ++i) {
+            int x = int(gen() % 1000002) - 1;
+            assert(index.lower_bound(x) == std::size_t(stl::lower_bound(sorted.begin(), sorted.end(), x)
+                                                       - sorted.begin()));
+        }
+        std::cout << "  passed" << std::endl << std::endl;
+    }
+
+    {
+        std::cout << "Comparator, non-trivial elements, copy and move:" << std::endl;
+        std::string words[] = {"pear", "kiwi", "fig", "banana", "apple"};   // descending
+        stl::static_search_index<std::string, std::greater<std::string>> index(words, words + 5);
+        assert(index.lower_bound("kiwi") == 1 && index.lower_bound("grape") == 2);
+        assert(index.lower_bound("zucchini") == 0 && index.lower_bound("") == 5);
+        assert(index.contains("fig") && !index.contains("cherry"));
+
+        stl::static_search_index<std::string, std::greater<std::string>> copied(index);
+        stl::static_search_index<std::string, std::greater<std::string>> moved(std::move(index));
+        assert(copied.lower_bound("banana") == 3 && moved.lower_bound("banana") == 3);
+        copied = moved;
+        assert(copied.size() == 5 && copied.contains("apple"));
+        std::cout << "  passed" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../work_stealing_deque.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    {
+        std::cout << "Owner pops LIFO, thieves steal FIFO:" << std::endl;
+        stl::work_stealing_deque<int> wsd(4);
+        assert(wsd.capacity() == 4 && wsd.empty());
+        for (int i = 0; i < 10; ++i)
+            wsd.push(i);            // grows 4 -> 8 -> 16
+        assert(wsd.size() == 10 && wsd.capacity() == 16);
+        int x;
+        assert(wsd.pop(x) && x == 9);
+        assert(wsd.steal(x) && x == 0);
+        assert(wsd.steal(x) && x == 1);
+        assert(wsd.pop(x) && x == 8);
+        while (wsd.pop(x)) { }
+        assert(x == 2 && wsd.empty() && !wsd.steal(x));
+        wsd.push(42);
+        assert(wsd.steal(x) && x == 42 && !wsd.pop(x));
+        std::cout << "  passed" << std::endl;
+    }
+
+    {
+        const int thieves = 3;
+        const long n = 200000;
+        std::cout << "Owner and " << thieves << " thieves:" << std::endl;
+        stl::work_stealing_deque<long> wsd(2);
+        std::vector<std::atomic<int>> seen(n);
+        std::atomic<bool> done(false);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < thieves; ++t)
+            workers.emplace_back([&] {
+                long x;
+                while (!done.load()) {
+                    if (wsd.steal(x))
+                        ++seen[x];
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        long x;
+        for (long i = 0; i < n; ++i) {
+            wsd.push(i);
+            if (i % 3 == 0 && wsd.pop(x))
+                ++seen[x];
+        }
+        while (wsd.pop(x))
+            ++seen[x];
+        done = true;
+        for (auto& w : workers)
+            w.join();
+        for (long i = 0; i < n; ++i)
+            assert(seen[i] == 1);
+        std::cout << "  " << n << " elements taken exactly once" << std::endl;
+    }
+
+    return 0;
+}
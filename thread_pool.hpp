@@ -0,0 +1,312 @@
+#ifndef STL_IMPL_THREAD_POOL_
+#define STL_IMPL_THREAD_POOL_
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "memory/alloc.hpp"
+#include "deque.hpp"
+#include "work_stealing_deque.hpp"
+#include "__epoch.hpp"
+#include "__concurrency.hpp"
+
+namespace stl {
+
+// Work-stealing thread pool.
+// Every worker owns a work_stealing_deque of tasks: tasks spawned by a
+// worker go to the bottom of its own deque, an idle worker steals from the
+// top of the others'.  Tasks spawned by other threads go through a locked
+// injection queue.  A thread waiting for its tasks (parallel_for) runs
+// pending tasks instead of blocking, so the calling thread is one more
+// worker and nested parallel calls cannot deadlock.  Workers with nothing to
+// do sleep on a condition variable; spawn() only notifies when one does.
+//
+// A task that lets an exception escape calls std::terminate, as the
+// standard parallel algorithms do.
+
+struct __pool_task {
+    void (*run)(__pool_task*);
+};
+
+class thread_pool {
+public:
+    explicit thread_pool(unsigned workers = default_workers());
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    unsigned workers() const { return nworkers; }
+    // threads taking part in a parallel_for: the workers and the caller
+    unsigned concurrency() const { return nworkers + 1; }
+
+    // Calls f(lo, hi) on the blocks [k * grain, min(n, (k + 1) * grain))
+    // of [0, n) in parallel and returns once all of them are done.
+    template<typename Function>
+    void parallel_for(std::size_t n, std::size_t grain, Function f);
+
+    // Runs f1 here and f2 as a task that may be stolen; returns when both
+    // are done.
+    template<typename Function1, typename Function2>
+    void fork_join(Function1 f1, Function2 f2);
+
+    static unsigned default_workers() {
+        unsigned hc = std::thread::hardware_concurrency();
+        return hc > 1 ? hc - 1 : 0;
+    }
+    // Shared pool of default_workers() threads, started on first use.
+    static thread_pool& default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+protected:
+    typedef work_stealing_deque<__pool_task*> task_deque;
+
+    struct worker_id {
+        thread_pool* pool;
+        unsigned index;
+        unsigned victim;        // where the next steal attempt starts
+    };
+    static worker_id& current() {
+        static thread_local worker_id id = {0, 0, 0};
+        return id;
+    }
+
+    void spawn(__pool_task* t);
+    __pool_task* find_task();
+    void worker_loop(unsigned index);
+    template<typename Predicate>
+    void help_until(Predicate done);
+
+    template<typename Function>
+    struct range_job;
+    template<typename Function>
+    struct range_task;
+    template<typename Function>
+    struct invoke_task;
+
+    unsigned nworkers;
+    task_deque* deques;
+    std::thread* threads;
+
+    std::mutex inject_mutex;
+    deque<__pool_task*, threaded_alloc> injected;
+    std::atomic<std::size_t> injected_count;
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<unsigned> work_epoch;       // bumped by every spawn
+    std::atomic<int> sleepers;
+    std::atomic<bool> stopping;
+};
+
+inline thread_pool::thread_pool(unsigned workers)
+ : nworkers(workers), deques(0), threads(0), injected_count(0),
+   work_epoch(0), sleepers(0), stopping(false)
+{
+    if (nworkers == 0)
+        return;
+    deques = new task_deque[nworkers];
+    threads = new std::thread[nworkers];
+    for (unsigned i = 0; i < nworkers; ++i)
+        threads[i] = std::thread([this, i] { worker_loop(i); });
+}
+
+inline thread_pool::~thread_pool()
+{
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_all();
+    for (unsigned i = 0; i < nworkers; ++i)
+        threads[i].join();
+    delete[] threads;
+    delete[] deques;
+}
+
+inline void thread_pool::spawn(__pool_task* t)
+{
+    worker_id& id = current();
+    if (id.pool == this) {
+        deques[id.index].push(t);
+    } else {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        injected.push_back(t);
+        injected_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    work_epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex); }
+        wake.notify_one();
+    }
+}
+
+inline __pool_task* thread_pool::find_task()
+{
+    worker_id& id = current();
+    __pool_task* t;
+    if (id.pool == this && deques[id.index].pop(t))
+        return t;
+    if (injected_count.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (!injected.empty()) {
+            t = injected.front();
+            injected.pop_front();
+            injected_count.fetch_sub(1, std::memory_order_relaxed);
+            return t;
+        }
+    }
+    for (unsigned i = 0; i < nworkers; ++i) {
+        unsigned victim = id.victim++ % nworkers;
+        if (deques[victim].steal(t))
+            return t;
+    }
+    return 0;
+}
+
+inline void thread_pool::worker_loop(unsigned index)
+{
+    worker_id& id = current();
+    id.pool = this;
+    id.index = index;
+    id.victim = index + 1;
+    for (;;) {
+        unsigned seen = work_epoch.load(std::memory_order_seq_cst);
+        __pool_task* t = find_task();
+        for (int spin = 0; !t && spin < 64; ++spin) {
+            __cpu_relax();
+            t = find_task();
+        }
+        if (t) {
+            t->run(t);
+            continue;
+        }
+        if (stopping.load())
+            return;
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        while (work_epoch.load(std::memory_order_seq_cst) == seen && !stopping.load())
+            wake.wait(lock);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename Predicate>
+void thread_pool::help_until(Predicate done)
+{
+    __backoff wait;
+    while (!done()) {
+        if (__pool_task* t = find_task()) {
+            t->run(t);
+            wait = __backoff();
+        } else {
+            wait();
+        }
+    }
+}
+
+// The blocks [lo, hi) are split in halves; the upper half becomes a task
+// for other workers to steal, the lower half is kept until a single block
+// is left.
+template<typename Function>
+struct thread_pool::range_job {
+    thread_pool* pool;
+    Function* f;
+    std::size_t n;
+    std::size_t grain;
+    std::atomic<std::size_t> pending;       // blocks not finished yet
+
+    void run_blocks(std::size_t lo, std::size_t hi) noexcept;
+};
+
+template<typename Function>
+struct thread_pool::range_task : __pool_task {
+    range_job<Function>* job;
+    std::size_t lo;
+    std::size_t hi;
+
+    static void execute(__pool_task* p) {
+        range_task* self = static_cast<range_task*>(p);
+        range_job<Function>* job = self->job;
+        std::size_t lo = self->lo, hi = self->hi;
+        __epoch::deallocate(self, sizeof(range_task));
+        job->run_blocks(lo, hi);
+    }
+};
+
+template<typename Function>
+void thread_pool::range_job<Function>::run_blocks(std::size_t lo, std::size_t hi) noexcept
+{
+    while (hi - lo > 1) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        range_task<Function>* t =
+            static_cast<range_task<Function>*>(__epoch::allocate(sizeof(range_task<Function>)));
+        t->run = &range_task<Function>::execute;
+        t->job = this;
+        t->lo = mid;
+        t->hi = hi;
+        pool->spawn(t);
+        hi = mid;
+    }
+    std::size_t end = (lo + 1) * grain;
+    (*f)(lo * grain, end < n ? end : n);
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+template<typename Function>
+void thread_pool::parallel_for(std::size_t n, std::size_t grain, Function f)
+{
+    if (grain == 0)
+        grain = 1;
+    std::size_t blocks = (n + grain - 1) / grain;
+    if (blocks <= 1 || nworkers == 0) {
+        for (std::size_t lo = 0; lo < n; lo += grain)
+            f(lo, n - lo > grain ? lo + grain : n);
+        return;
+    }
+    range_job<Function> job;
+    job.pool = this;
+    job.f = &f;
+    job.n = n;
+    job.grain = grain;
+    job.pending.store(blocks, std::memory_order_relaxed);
+    job.run_blocks(0, blocks);
+    help_until([&job] { return job.pending.load(std::memory_order_acquire) == 0; });
+}
+
+template<typename Function>
+struct thread_pool::invoke_task : __pool_task {
+    Function* f;
+    std::atomic<bool> done;
+
+    static void execute(__pool_task* p) noexcept {
+        invoke_task* self = static_cast<invoke_task*>(p);
+        (*self->f)();
+        self->done.store(true, std::memory_order_release);
+    }
+};
+
+template<typename Function1, typename Function2>
+void thread_pool::fork_join(Function1 f1, Function2 f2)
+{
+    if (nworkers == 0) {
+        f1();
+        f2();
+        return;
+    }
+    // the task lives in this frame, we do not leave before it has run
+    invoke_task<Function2> task;
+    task.run = &invoke_task<Function2>::execute;
+    task.f = &f2;
+    task.done.store(false, std::memory_order_relaxed);
+    spawn(&task);
+    [&f1]() noexcept { f1(); }();
+    help_until([&task] { return task.done.load(std::memory_order_acquire); });
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_THREAD_POOL_ */
@@ -0,0 +1,172 @@
+#ifndef STL_IMPL_WORK_STEALING_DEQUE_
+#define STL_IMPL_WORK_STEALING_DEQUE_
+
+#include <cstddef>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include "memory/alloc.hpp"
+#include "ring_buffer.hpp"
+#include "__epoch.hpp"
+#include "__concurrency.hpp"
+
+namespace stl {
+
+using namespace memory;
+
+// Chase-Lev work-stealing deque (with the C11 orderings of Le et al. 2013).
+// One owner thread pushes and pops at the bottom; any thread may steal from
+// the top.  The owner's push and pop touch only plain loads/stores and
+// fences, a CAS on top is needed only when pop races a thief for the last
+// element.  The storage is a circular array that the owner doubles when it
+// is full; a thief may still be reading the old array, so that is retired
+// through __epoch instead of being freed.
+//
+// Slots are read speculatively by thieves, so T must be trivially copyable
+// (typically a pointer or a small task handle).
+template<typename T, typename Alloc = threaded_alloc>
+class work_stealing_deque {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "work_stealing_deque requires a trivially copyable T");
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+protected:
+    typedef std::ptrdiff_t index_type;      // bottom - 1 may drop below top
+
+    struct array : __epoch_node {
+        size_type mask;
+        std::atomic<value_type>* slots() {
+            return reinterpret_cast<std::atomic<value_type>*>(this + 1);
+        }
+        value_type get(index_type i) {
+            return slots()[i & mask].load(std::memory_order_relaxed);
+        }
+        void put(index_type i, value_type x) {
+            slots()[i & mask].store(x, std::memory_order_relaxed);
+        }
+    };
+
+    static std::size_t array_bytes(size_type n) {
+        return sizeof(array) + n * sizeof(std::atomic<value_type>);
+    }
+    static array* new_array(size_type n);
+    static void delete_array(array* a) {
+        Alloc::deallocate(a, array_bytes(a->mask + 1));
+    }
+    static void reclaim_array(__epoch_node* p) {
+        delete_array(static_cast<array*>(p));
+    }
+    array* grow(array* a, index_type t, index_type b);
+
+    alignas(__cache_line_size) std::atomic<index_type> top;     // thieves
+    alignas(__cache_line_size) std::atomic<index_type> bottom;  // owner
+    std::atomic<array*> buf;
+
+public:
+    explicit work_stealing_deque(size_type capacity = 64)
+     : top(0), bottom(0), buf(new_array(stl::__ring_buffer_capacity(capacity))) { }
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+    // No thief may be running any more.
+    ~work_stealing_deque() { delete_array(buf.load(std::memory_order_relaxed)); }
+
+public:
+    // A snapshot unless called by the owner with no thieves around.
+    size_type size() const {
+        index_type b = bottom.load(std::memory_order_relaxed);
+        index_type t = top.load(std::memory_order_relaxed);
+        return b > t ? size_type(b - t) : 0;
+    }
+    bool empty() const { return size() == 0; }
+    size_type capacity() const { return buf.load(std::memory_order_relaxed)->mask + 1; }
+
+    // owner only
+    void push(value_type x);
+    bool pop(value_type& x);
+
+    // any thread; false when empty or when another thread won the element
+    bool steal(value_type& x);
+
+};
+
+template<typename T, typename Alloc>
+typename work_stealing_deque<T, Alloc>::array*
+work_stealing_deque<T, Alloc>::new_array(size_type n)
+{
+    array* a = static_cast<array*>(Alloc::allocate(array_bytes(n)));
+    new (a) array;
+    a->mask = n - 1;
+    std::atomic<value_type>* s = a->slots();
+    for (size_type i = 0; i < n; ++i)
+        new (s + i) std::atomic<value_type>();
+    return a;
+}
+
+template<typename T, typename Alloc>
+typename work_stealing_deque<T, Alloc>::array*
+work_stealing_deque<T, Alloc>::grow(array* a, index_type t, index_type b)
+{
+    array* na = new_array((a->mask + 1) * 2);
+    for (index_type i = t; i < b; ++i)
+        na->put(i, a->get(i));
+    buf.store(na, std::memory_order_release);
+    __epoch::retire(a, reclaim_array);
+    return na;
+}
+
+template<typename T, typename Alloc>
+void work_stealing_deque<T, Alloc>::push(value_type x)
+{
+    index_type b = bottom.load(std::memory_order_relaxed);
+    index_type t = top.load(std::memory_order_acquire);
+    array* a = buf.load(std::memory_order_relaxed);
+    if (b - t > index_type(a->mask))
+        a = grow(a, t, b);
+    a->put(b, x);
+    // a release store rather than Le et al.'s release fence + relaxed store:
+    // the same code on x86, and visible to ThreadSanitizer
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+template<typename T, typename Alloc>
+bool work_stealing_deque<T, Alloc>::pop(value_type& x)
+{
+    index_type b = bottom.load(std::memory_order_relaxed) - 1;
+    array* a = buf.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    index_type t = top.load(std::memory_order_relaxed);
+    if (t > b) {                // empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    x = a->get(b);
+    if (t == b) {               // the last element, race the thieves for it
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T, typename Alloc>
+bool work_stealing_deque<T, Alloc>::steal(value_type& x)
+{
+    index_type t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    index_type b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+        return false;
+    __epoch::guard pinned;      // the owner may retire the array under us
+    array* a = buf.load(std::memory_order_acquire);
+    x = a->get(t);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed);
+}
+
+}  // end of namespace stl
+
+#endif /* STL_IMPL_WORK_STEALING_DEQUE_ */